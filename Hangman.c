@@ -3,19 +3,664 @@
 #include <string.h>
 #include <stdbool.h>
 #include "HangmanLib.c"
-#define MAX_LENGTH 40
+#include "HangmanServer.c"
 
-int main() {
-    FILE *file = NULL;
-    char line[MAX_LENGTH];
+/**
+ * @brief Allows the user to insert words into the file, handling input until the user enters "0".
+ * 
+ * This function continuously prompts the user to input words, which are then added to the file.
+ * The user can stop the insertion process by entering "0". The function also checks for empty input
+ * and ensures that only non-empty words are added to the file. Every added word is committed to the
+ * journal and also appended to the first shard of the catalog, so it can be guessed without reloading
+ * the file. Without a loaded catalog the journal is compacted right away, as duplicates are looked
+ * up in the word files themselves.
+ * 
+ * @param catalog The catalog of word files.
+ * @param journal The journal the words are committed to.
+ * @param line Buffer of `MAX_LENGTH` bytes to store the input word from the user.
+ */
+void WordInsertion (Catalog *catalog, Journal *journal, char *line){
+    bool truncated;
+    printf("Please enter the word you want to add: ");
+    while (ReadLine(stdin, line, MAX_LENGTH, &truncated))
+    { 
+        if (strcmp(line, "0") == 0)
+        {
+            break;
+        }
+        if(truncated){
+            printf("Invalid word. Words may be at most %d characters long.\n", MAX_LENGTH - 1);
+            return;
+        }
+        if(!IsValidWord(line)){
+            return;
+        }
+        if (!WordAlreadyInFile(catalog, line))
+        {
+            JournalAppend(journal, line, strlen(line));
+            JournalCommit(journal);
+            if (catalog->loaded) {
+                DictionaryAdd(catalog->shards[0], line, strlen(line));
+            } else {
+                JournalCompact(journal);
+            }
+            printf("Word %s has been added.\n", line);
+        }
+        else if( strlen(line) <= 0)
+        {
+            printf("Invalid word. Please enter a non-empty word.\n");
+        }
+        printf("If you want to continue adding write the words. Otherwise 0: ");
+    }
+}
+
+/**
+ * @brief ASCII art of the hangman for every number of incorrect guesses.
+ * 
+ * Each stage is a single constant string, so a stage is printed with one call
+ * instead of one per line.
+ */
+const char *const GallowsStages[MAX_WRONG_GUESSES + 1] = {  // ASCII art by ChatGPT <33
+    "   +---+\n"
+    "   |   |\n"
+    "       |\n"
+    "       |\n"
+    "       |\n"
+    "       |\n"
+    "==========\n",
+    "   +---+\n"
+    "   |   |\n"
+    "   O   |\n"
+    "       |\n"
+    "       |\n"
+    "       |\n"
+    "=========\n",
+    "   +---+\n"
+    "   |   |\n"
+    "   O   |\n"
+    "   |   |\n"
+    "       |\n"
+    "       |\n"
+    "==========\n",
+    "   +---+\n"
+    "   |   |\n"
+    "   O   |\n"
+    "  /|   |\n"
+    "       |\n"
+    "       |\n"
+    "==========\n",
+    "   +---+\n"
+    "   |   |\n"
+    "   O   |\n"
+    "  /|\\  |\n"
+    "       |\n"
+    "       |\n"
+    "==========\n",
+    "   +---+\n"
+    "   |   |\n"
+    "   O   |\n"
+    "  /|\\  |\n"
+    "  /    |\n"
+    "       |\n"
+    "==========\n",
+    "   +---+\n"
+    "   |   |\n"
+    "   O   |\n"
+    "  /|\\  |\n"
+    "  / \\  |\n"
+    "       |\n"
+    "==========\n"
+    "\n"
+};
+
+/**
+ * @brief Prints the current state of the hangman based on the number of incorrect guesses.
+ * 
+ * This function displays an ASCII art representation of the hangman, with different stages
+ * corresponding to the number of incorrect guesses made by the player. The final state indicates
+ * that the game is over.
+ * 
+ * @param state The current number of incorrect guesses (ranging from 0 to 6).
+ */
+void PrintState(int state) {
+    fputs(GallowsStages[state], stdout);
+}
+
+/**
+ * @brief Clear the terminal before every frame instead of scrolling, set by `--redraw`.
+ */
+bool RedrawFrames = false;
+
+/**
+ * @brief Renders a whole frame of the game into a buffer.
+ * 
+ * A frame is the hangman of the current state followed by the board and the
+ * prompt for the next guess, optionally preceded by the ANSI sequence that
+ * moves the cursor home and clears the terminal.
+ * 
+ * @param game The game to render.
+ * @param frame Buffer to render into.
+ * @param size Size of the buffer.
+ * @return Length of the rendered frame.
+ */
+size_t RenderFrame(const Game *game, char *frame, size_t size) {
+    uint64_t start = StatStart();
+    int length = snprintf(frame, size, "%s%sMake your guess %s      ",
+                          RedrawFrames ? "\033[H\033[J" : "", GallowsStages[game->state], GameBoard(game));
+    StatStop(STAT_RENDER, start);
+    return length < 0 ? 0 : (size_t)length < size ? (size_t)length : size - 1;
+}
+
+/**
+ * @brief The computer player behind hints and watched games of the console.
+ * 
+ * The solver index is only built from the catalog the first time a hint is
+ * asked for, and built again after the words have changed.
+ */
+typedef struct {
+    const Catalog *catalog;     // The words to build the index from
+    SolverIndex index;          // Index of the words, empty until it is needed
+    Solver solver;              // The computer player, following the current game
+    bool following;             // The solver has started following the current game
+} Hints;
+
+/**
+ * @brief Prepares the hints for the words of a catalog without building the index yet.
+ * 
+ * @param hints The hints to initialize.
+ * @param catalog The catalog, which must outlive the hints.
+ */
+void HintsInit(Hints *hints, const Catalog *catalog) {
+    hints->catalog = catalog;
+    SolverIndexInit(&hints->index);
+    SolverInit(&hints->solver, &hints->index);
+    hints->following = false;
+}
+
+/**
+ * @brief Drops the index after the words of the catalog have changed.
+ * 
+ * @param hints The hints.
+ */
+void HintsReset(Hints *hints) {
+    SolverIndexFree(&hints->index);
+    hints->following = false;
+}
+
+/**
+ * @brief Releases all memory of the hints.
+ * 
+ * @param hints The hints.
+ */
+void HintsFree(Hints *hints) {
+    SolverFree(&hints->solver);
+    SolverIndexFree(&hints->index);
+}
+
+/**
+ * @brief Returns the solver following the game, building the index first if needed.
+ * 
+ * @param hints The hints.
+ * @param game The game in progress.
+ * @return The solver, synced with the game.
+ */
+Solver *HintsFor(Hints *hints, const Game *game) {
+    if (hints->index.groups == NULL) {
+        SolverIndexBuild(&hints->index, hints->catalog->shards, hints->catalog->count);
+        hints->following = false;
+    }
+    if (!hints->following) {
+        SolverStart(&hints->solver, game);
+        hints->following = true;
+    }
+    SolverSync(&hints->solver, game);
+    return &hints->solver;
+}
+
+/**
+ * @brief Prompts the user to enter a guess and checks if it's valid.
+ * 
+ * This function reads a whole line from the buffered standard input and parses
+ * it with `ParseGuess`, so it never reads byte by byte. A valid guess is either
+ * a single alphabetic letter (A-Z or a-z), the whole word or "?" for a hint.
+ * Invalid lines are reported and the user is asked again.
+ * 
+ * @param guess Filled with the parsed guess.
+ * @param line Buffer to store the line typed by the user; the guess points into it.
+ * @param size Size of the buffer.
+ * @return true if a valid guess was read, false if the input has ended.
+ */
+bool GetValidGuess(ParsedGuess *guess, char *line, size_t size) {
+    bool truncated;
+    uint64_t wait = NowNanoseconds();
+    while (ReadLine(stdin, line, size, &truncated)) {
+        TraceEventAdd("input wait", wait, NowNanoseconds(), NULL, 0);
+        if (!truncated && ParseGuess(line, guess) != INPUT_INVALID) {
+            return true;
+        }
+        printf("Invalid input. Please enter one letter or the whole word.\n");
+        wait = NowNanoseconds();
+    }
+    return false;
+}
+
+/**
+ * @brief Updates the game state based on the player's guess.
+ * 
+ * This function prints the current hangman state and the board, then reads
+ * guesses from the player until one of them is a valid new guess, which is
+ * applied to the game. The function also ensures that the player enters a
+ * valid letter or word, and answers "?" with the letter the solver suggests.
+ * 
+ * @param game The game that the player is playing.
+ * @param hints The computer player that gives the hints.
+ * @return The outcome of the guess, or GUESS_INVALID if the input has ended.
+ */
+GuessResult ResolveState (Game *game, Hints *hints){
+    char line[MAX_LENGTH]; ParsedGuess guess; GuessResult result;
+
+    // Emit the whole frame with a single write
+    char frame[256 + MAX_LENGTH];
+    fwrite(frame, 1, RenderFrame(game, frame, sizeof(frame)), stdout);
+    fflush(stdout);
+    if (game->guessed == 0 && game->state == 0) {
+        TraceMark("first board");
+    }
+    do {
+        if (!GetValidGuess(&guess, line, sizeof(line))) {
+            return GUESS_INVALID;
+        }
+        if (guess.kind == INPUT_HINT) {
+            Solver *solver = HintsFor(hints, game);
+            if (SolverCandidates(solver) == 1) {
+                printf("Hint: the word is probably %.*s.\n", (int)game->length, SolverCandidate(solver, 0));
+            } else {
+                printf("Hint: try %c, %zu words still fit.\n", SolverHint(solver, game), SolverCandidates(solver));
+            }
+            result = GUESS_REPEATED;    // Ask for the guess again
+            continue;
+        }
+        result = GameApplyGuess(game, &guess);
+        if (result == GUESS_REPEATED) {
+            printf("You already guessed %c. Try another letter.\n", guess.letter);
+        }
+    } while (result == GUESS_REPEATED);
+    return result;
+}
 
+/**
+ * @brief Compiles the dictionary into a file and reports the result.
+ * 
+ * @param dict The dictionary loaded from the word file.
+ * @param filename Name of the compiled dictionary file.
+ * @param source Signature of the word file the dictionary was loaded from.
+ */
+void CompileDictionary(const Dictionary *dict, const char *filename, const FileSignature *source){
+    DictionaryCompile(dict, filename, source);
+    if (!CompiledFileValid(filename)) {
+        printf("Compiled dictionary %s is corrupted.\n", filename);
+        exit(1);
+    }
+    printf("Compiled %zu words into %s.\n", dict->count, filename);
+}
+
+/**
+ * @brief Compiles every shard of the catalog next to its word file.
+ * 
+ * The journal must be compacted, so the word files hold all the words of the shards.
+ * 
+ * @param catalog The loaded catalog.
+ * @param journal The journal added words are committed to.
+ */
+void CompileCatalog(const Catalog *catalog, const Journal *journal){
+    for (size_t i = 0; i < catalog->count; i++) {
+        char compiled[FILENAME_MAX];
+        DerivedFilename(compiled, sizeof(compiled), catalog->filenames[i], COMPILED_EXTENSION);
+        CompileDictionary(catalog->shards[i], compiled, CatalogShardSignature(catalog, journal, i));
+    }
+}
+
+/**
+ * @brief Manages the main logic for the word guessing game.
+ * 
+ * This function orchestrates the word guessing game by selecting a random word from the catalog,
+ * starting a game with it, and then allowing the player to guess letters
+ * until they either win or lose. The player's state (number of wrong guesses) is updated with
+ * each incorrect guess.
+ * 
+ * @param catalog The catalog of word files to guess from, see `CatalogSelect`.
+ * @param rng The random number generator used to select the word.
+ * @param filter Length and difficulty the word must have.
+ * @param hints The computer player that gives hints during the game.
+ * @param players The store the result of the game is recorded in.
+ * @param player Name of the player.
+ */
+void WordGuessing(const Catalog *catalog, Rng *rng, const WordFilter *filter, Hints *hints, PlayerStore *players, const char *player){
+    char WordToGuess[MAX_LENGTH];
+    uint64_t played = NowNanoseconds();
+    if(!CatalogSelect(catalog, rng, filter, WordToGuess)){
+        if(filter->length != 0 || filter->difficulty != DIFFICULTY_ANY){
+            printf("No words like that to guess.\n");
+            return;
+        }
+        printf("No words to guess.\n");
+        exit(0);
+    }
+    Game game;
+    GameStart(&game, WordToGuess);
+    TraceEventAdd("new game", played, NowNanoseconds(), "length", (int64_t)game.length);
+    hints->following = false;
+    while(!GameIsWon(&game) && !GameIsLost(&game)){
+        if(ResolveState(&game, hints) == GUESS_INVALID){
+            printf("\n");
+            GameEnd(&game);
+            return;     // The input has ended in the middle of the game
+        }
+    }
+    if(GameIsWon(&game)){
+        printf("You WON!\n Thw word was %s\n", WordToGuess);
+    } else {
+        PrintState(game.state);
+        printf("Game Over!\nThe word was %s. \n", WordToGuess);
+    }
+    if(PlayerStoreRecord(players, player, GameIsWon(&game), (uint64_t)game.state)){
+        PlayerStoreFlush(players);  // A whole batch of results is written at once
+    }
+    TraceEventAdd(GameIsWon(&game) ? "game won" : "game lost", played, NowNanoseconds(), "wrong guesses", game.state);
+    GameEnd(&game);
+}
+
+/**
+ * @brief Prints the players with the most wins.
+ * 
+ * @param players The store of the players.
+ */
+void PrintLeaderboard(const PlayerStore *players){
+    PlayerStats top[PLAYER_TOP];
+    char line[PLAYER_LINE];
+    size_t count = PlayerStoreTop(players, top, PLAYER_TOP);
+    if(count == 0){
+        printf("No games finished yet.\n");
+    }
+    for(size_t i = 0; i < count; i++){
+        PlayerStatsLine(line, i + 1, &top[i]);
+        fputs(line, stdout);
+    }
+}
+
+/**
+ * @brief Lets the computer player guess a random word while the user watches.
+ * 
+ * @param catalog The catalog of word files to guess from, see `CatalogSelect`.
+ * @param rng The random number generator used to select the word.
+ * @param filter Length and difficulty the word must have.
+ * @param hints The computer player.
+ */
+void WordWatching(const Catalog *catalog, Rng *rng, const WordFilter *filter, Hints *hints){
+    char WordToGuess[MAX_LENGTH];
+    if(!CatalogSelect(catalog, rng, filter, WordToGuess)){
+        printf("No words like that to guess.\n");
+        return;
+    }
+    Game game; ParsedGuess guess;
+    GameStart(&game, WordToGuess);
+    hints->following = false;
+    while(!GameIsWon(&game) && !GameIsLost(&game)){
+        Solver *solver = HintsFor(hints, &game);
+        size_t candidates = SolverCandidates(solver);
+        SolverNextGuess(solver, &game, &guess);
+        if(guess.kind == INPUT_INVALID){
+            break;
+        }
+        GuessResult result = GameApplyGuess(&game, &guess);
+        printf("The computer guesses %.*s out of %zu words: %s%s\n", (int)guess.length,
+               guess.kind == INPUT_WORD ? guess.word : &guess.letter, candidates, GameBoard(&game),
+               result == GUESS_MISS ? " (miss)" : "");
+    }
+    PrintState(game.state);
+    printf("The computer %s. The word was %s.\n", GameIsWon(&game) ? "WON" : "lost", WordToGuess);
+    GameEnd(&game);
+}
+
+/**
+ * @brief Handles user commands to either play a game or add words to a file.
+ * 
+ * The function checks the user's input (`line`) to determine whether they want to play the game or 
+ * add words to a file. Games are played from the catalog of word files, while
+ * the `WordInsertion` function adds words to both the first word file and its shard. The command
+ * "add --bulk <file|->" imports a whole word list at once with `WordBulkInsertion`, and
+ * "compile" writes every shard next to its word file for fast startup.
+ * "play" may be followed by a word length and a difficulty, e.g. "play 7 hard", and so may
+ * "watch", which lets the computer player guess a word instead. "top" prints the
+ * players with the most wins.
+ * If the user inputs an unrecognized command, the function returns `false` to indicate that the 
+ * game should not continue.
+ * 
+ * @param catalog The catalog of word files, loaded or not.
+ * @param rng The random number generator used to select words.
+ * @param journal The journal added words are committed to.
+ * @param hints The computer player for hints and watched games.
+ * @param players The store the results of the games are recorded in.
+ * @param player Name of the player.
+ * @param line Buffer of `MAX_LENGTH` bytes holding the user's input command without the newline.
+ * @return true if the game should continue, false otherwise.
+ */
+bool GameContinues(Catalog *catalog, Rng *rng, Journal *journal, Hints *hints, PlayerStore *players, const char *player, char *line){
+    WordFilter filter;
+    if ((strncmp(line, "play", 4) == 0 && (line[4] == '\0' || line[4] == ' ')) && ParseWordFilter(line + 4, &filter)) {
+        WordGuessing(catalog, rng, &filter, hints, players, player);
+    } 
+    else if ((strncmp(line, "watch", 5) == 0 && (line[5] == '\0' || line[5] == ' ')) && ParseWordFilter(line + 5, &filter)) {
+        WordWatching(catalog, rng, &filter, hints);
+    }
+    else if (strcmp(line, "add") == 0) {
+        WordInsertion(catalog, journal, line);
+        HintsReset(hints);
+    }
+    else if (strcmp(line, "stats") == 0) {
+        StatsPrint(stdout);
+    }
+    else if (strcmp(line, "top") == 0) {
+        PrintLeaderboard(players);
+    }
+    else if (strncmp(line, "add --bulk ", 11) == 0 || strcmp(line, "compile") == 0) {
+        // These commands need the hash indexes, so load them just for them when they are not preloaded
+        Catalog loaded;
+        if (!catalog->loaded) {
+            CatalogInit(&loaded);
+            for (size_t i = 0; i < catalog->count; i++) {
+                CatalogAdd(&loaded, catalog->filenames[i]);
+            }
+            CatalogOpen(&loaded, true);
+        }
+        if (strcmp(line, "compile") == 0) {
+            JournalCompact(journal);    // The compiled files must match the word files
+            CompileCatalog(catalog->loaded ? catalog : &loaded, journal);
+        } else {
+            WordBulkInsertion(catalog->loaded ? catalog : &loaded, journal, line + 11);
+            HintsReset(hints);
+        }
+        if (!catalog->loaded) {
+            JournalCompact(journal);    // Readers of the word file must see the new words
+            CatalogFree(&loaded);
+        }
+    } else {
+        printf("Looks like you do not want to do any of that. Bye!\n");
+        return false;
+    }
+    printf("Do you want to continue play or add ?");
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    char line[MAX_LENGTH], journalName[FILENAME_MAX];
+    Catalog catalog;
+    Journal journal;
+    PlayerStore players;
+    Hints hints;
+    Rng rng;
+    bool preload = true;
+    const char *player = PLAYER_DEFAULT;
+    int arg = 1;
+
+    RngSeed(&rng, RngDefaultSeed());
+    CatalogInit(&catalog);
+    for (; arg < argc && strncmp(argv[arg], "--", 2) == 0; arg++) {
+        if (strcmp(argv[arg], "--cold") == 0) {
+            preload = false;    // Read the word file on every game instead of caching it
+        } else if (strcmp(argv[arg], "--no-stats") == 0) {
+            StatsEnabled = false;   // Do not measure the hot paths
+        } else if (strcmp(argv[arg], "--compact") == 0) {
+            catalog.compact = true;     // Keep the words sorted and front-coded to save memory
+        } else if (strcmp(argv[arg], "--shared") == 0) {
+            catalog.shared = true;      // Compile the word files when needed and map them, one copy for all processes
+        } else if (strcmp(argv[arg], "--profile") == 0 && arg + 1 < argc) {
+            TraceOpen(argv[++arg]);     // Chrome trace of the phases of startup and every game
+            atexit(TraceClose);
+        } else if (strcmp(argv[arg], "--redraw") == 0) {
+            RedrawFrames = true;    // Redraw the board in place instead of scrolling
+        } else if (strcmp(argv[arg], "--player") == 0 && arg + 1 < argc) {
+            player = argv[++arg];     // Name the results of the games are recorded under
+            if (!PlayerNameValid(player)) {
+                fprintf(stderr, "Invalid player name %s\n", player);
+                return 1;
+            }
+        } else if (strcmp(argv[arg], "--seed") == 0 && arg + 1 < argc) {
+            RngSeed(&rng, strtoull(argv[++arg], NULL, 10));   // Reproducible word selection
+        } else if (strcmp(argv[arg], "--words") == 0 && arg + 1 < argc) {
+            if (!CatalogAdd(&catalog, argv[++arg])) {   // One more word file, in a shard of its own
+                fprintf(stderr, "Too many word files, at most %d\n", CATALOG_MAX_SHARDS);
+                return 1;
+            }
+        } else if (strcmp(argv[arg], "--catalog") == 0 && arg + 1 < argc) {
+            if (!CatalogAddList(&catalog, argv[++arg])) {   // Word files listed one per line
+                fprintf(stderr, "Too many word files, at most %d\n", CATALOG_MAX_SHARDS);
+                return 1;
+            }
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[arg]);
+            return 1;
+        }
+    }
+
+    if (catalog.count == 0) {
+        CatalogAdd(&catalog, FILENAME);
+    }
+    if (arg < argc && strcmp(argv[arg], "compile") == 0) {
+        catalog.compact = false;    // Compiled files hold the words as they are
+    }
+    uint64_t phase = NowNanoseconds();
+    CatalogOpen(&catalog, preload || arg < argc);
+    TraceEventAdd("dictionary open", phase, NowNanoseconds(), "files", (int64_t)catalog.count);
+    // Words committed to the journal before a crash are merged into the first word file first
+    phase = NowNanoseconds();
+    DerivedFilename(journalName, sizeof(journalName), catalog.filenames[0], JOURNAL_EXTENSION);
+    JournalOpen(&journal, journalName, catalog.filenames[0], catalog.loaded ? catalog.shards[0] : NULL);
+    JournalCompact(&journal);
+    TraceEventAdd("journal open", phase, NowNanoseconds(), NULL, 0);
+
+    // Non-interactive compile: Hangman compile [output], the output is for the first word file
+    if (arg < argc && strcmp(argv[arg], "compile") == 0 && argc - arg <= 2) {
+        if (argc - arg == 2) {
+            CompileDictionary(catalog.shards[0], argv[arg + 1], CatalogShardSignature(&catalog, &journal, 0));
+        } else {
+            CompileCatalog(&catalog, &journal);
+        }
+        JournalClose(&journal);
+        CatalogFree(&catalog);
+        return 0;
+    }
+
+    // Headless replay of recorded games: Hangman replay <file|->
+    if (argc - arg == 2 && strcmp(argv[arg], "replay") == 0) {
+        FILE *records = stdin;
+        if (strcmp(argv[arg + 1], "-") != 0) {
+            FileOpenError(&records, argv[arg + 1], "r");
+        }
+        ReplayGames(&catalog, records, stdout);
+        if (records != stdin) {
+            CloseFile(&records);
+        }
+        JournalClose(&journal);
+        CatalogFree(&catalog);
+        return 0;
+    }
+
+    // Self-play of the solver against every word: Hangman simulate <games> [mistakes] [threads]
+    if (argc - arg >= 2 && argc - arg <= 4 && strcmp(argv[arg], "simulate") == 0) {
+        char *end;
+        unsigned long games = strtoul(argv[arg + 1], &end, 10);
+        if (!isdigit((unsigned char)argv[arg + 1][0]) || *end != '\0' || games == 0 || games > UINT32_MAX) {
+            fprintf(stderr, "Invalid number of games %s\n", argv[arg + 1]);
+            JournalClose(&journal);
+            CatalogFree(&catalog);
+            return 1;
+        }
+        SimulateGames(&catalog, (uint32_t)games,
+                      argc - arg >= 3 ? (unsigned)atoi(argv[arg + 2]) : SIMULATION_MISTAKES, RngNext(&rng),
+                      argc - arg == 4 ? (size_t)atoi(argv[arg + 3]) : 0, stdout);
+        JournalClose(&journal);
+        CatalogFree(&catalog);
+        return 0;
+    }
+
+    // Non-interactive bulk import: Hangman add --bulk <file|->
+    if (argc - arg == 3 && strcmp(argv[arg], "add") == 0 && strcmp(argv[arg + 1], "--bulk") == 0) {
+        WordBulkInsertion(&catalog, &journal, argv[arg + 2]);
+        JournalCompact(&journal);
+        JournalClose(&journal);
+        CatalogFree(&catalog);
+        return 0;
+    }
+
+    // The statistics of the players are kept next to the first word file
+    phase = NowNanoseconds();
+    PlayerStoreOpen(&players, catalog.filenames[0]);
+    TraceEventAdd("players open", phase, NowNanoseconds(), "players", (int64_t)players.count);
+
+    // Multi-session server: Hangman serve [port|unix:path] [threads]
+    if (arg < argc && strcmp(argv[arg], "serve") == 0 && argc - arg <= 3) {
+        char port[16];
+        snprintf(port, sizeof(port), "%d", SERVER_PORT);
+        int code = ServeGames(&catalog, &journal, &players, &rng, argc - arg >= 2 ? argv[arg + 1] : port,
+                              argc - arg == 3 ? atoi(argv[arg + 2]) : SERVER_THREADS);
+        PlayerStoreClose(&players);
+        JournalClose(&journal);
+        CatalogFree(&catalog);
+        return code;
+    }
+
+    HintsInit(&hints, &catalog);
     printf("Do you want to play or add words? ");
-    while (fgets(line, MAX_LENGTH, stdin) != NULL) {
-        if (!GameContinues(&file, line)) {
+    fflush(stdout);
+    phase = NowNanoseconds();
+    TraceEventAdd("startup", TraceOrigin, phase, NULL, 0);
+    bool truncated;
+    while (ReadLine(stdin, line, MAX_LENGTH, &truncated)) {
+        TraceEventAdd("input wait", phase, NowNanoseconds(), NULL, 0);
+        if (truncated) {
+            printf("Invalid input. Commands may be at most %d characters long. ", MAX_LENGTH - 1);
+            fflush(stdout);
+            phase = NowNanoseconds();
+            continue;
+        }
+        if (catalog.loaded && CatalogReload(&catalog, &journal)) {
+            HintsReset(&hints);     // Pick up changes made to the word files meanwhile
+        }
+        if (!GameContinues(&catalog, &rng, &journal, &hints, &players, player, line)) {
             break;
         }
+        if (journal.records >= JOURNAL_COMPACT_RECORDS) {
+            JournalCompact(&journal);
+        }
+        TraceFlush();   // The trace of every game is written once it is over
+        phase = NowNanoseconds();
     }
 
-    CloseFile(&file);
+    JournalCompact(&journal);
+    JournalClose(&journal);
+    PlayerStoreClose(&players);
+    HintsFree(&hints);
+    CatalogFree(&catalog);
     return 0;
 }
@@ -0,0 +1,523 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "HangmanLib.c"
+#define BENCH_FILENAME "HangmanBench.tmp"
+#define BENCH_COMPILED "HangmanBench.tmp.bin"
+#define BENCH_JOURNAL "HangmanBench.tmp.journal"
+#define BENCH_PLAYERS "HangmanBench.players"
+#define BENCH_RESULTS "HangmanBench.results"
+#define BENCH_BUDGET 2000000000ULL
+#define OLD_MAX_LENGTH 40
+
+/**
+ * @brief Keeps the compiler from optimizing away the work being measured.
+ */
+volatile uint64_t BenchSink;
+
+/**
+ * @brief Prints one line of benchmark results.
+ *
+ * @param name Name of the benchmark.
+ * @param words Number of words in the dictionary.
+ * @param ops Number of operations measured.
+ * @param ns Total time of all operations in nanoseconds.
+ */
+void BenchReport(const char *name, size_t words, uint64_t ops, uint64_t ns) {
+    double perOp = ops ? (double)ns / (double)ops : 0.0;
+    printf("%-32s %11zu words %14.1f ns/op %14.0f ops/s\n", name, words, perOp, perOp > 0 ? 1e9 / perOp : 0.0);
+    fflush(stdout);
+}
+
+/**
+ * @brief Counts the bytes a dictionary holds on the heap for its words, index and buckets.
+ *
+ * @param dict The dictionary, not loaded from a compiled file.
+ * @return The bytes allocated.
+ */
+size_t BenchDictionaryBytes(const Dictionary *dict) {
+    size_t bytes = dict->capacity + dict->offsetCapacity * sizeof(uint64_t) + dict->index.capacity * sizeof(uint64_t)
+                 + dict->compact.size + (dict->compact.words + FRONT_BLOCK_WORDS - 1) / FRONT_BLOCK_WORDS * sizeof(uint64_t);
+    for (size_t i = 0; i < WORD_BUCKETS; i++) {
+        bytes += dict->buckets[i].capacity * sizeof(uint64_t);
+    }
+    return bytes;
+}
+
+/**
+ * @brief Number of repetitions of an operation that scans the whole dictionary.
+ *
+ * Old code paths are O(words) per operation, so they are repeated less often
+ * on large dictionaries to keep every benchmark within a similar time budget.
+ *
+ * @param words Number of words in the dictionary.
+ * @param max Upper limit of repetitions.
+ * @return Number of repetitions, at least 1.
+ */
+uint64_t BenchScans(size_t words, uint64_t max) {
+    uint64_t scans = BENCH_BUDGET / 50 / (words + 1);
+    return scans < 1 ? 1 : scans > max ? max : scans;
+}
+
+/**
+ * @brief Writes a synthetic word file with random lowercase words.
+ *
+ * @param filename Name of the file to write.
+ * @param words Number of words.
+ * @param rng Generator of the words.
+ */
+void BenchGenerate(const char *filename, size_t words, Rng *rng) {
+    FILE *file;
+    char word[MAX_LENGTH];
+    FileOpenError(&file, filename, "wb");
+    for (size_t i = 0; i < words; i++) {
+        size_t length = 3 + RngBounded(rng, 10);
+        for (size_t j = 0; j < length; j++) {
+            word[j] = (char)('a' + RngBounded(rng, 26));
+        }
+        word[length] = '\n';
+        fwrite(word, 1, length + 1, file);
+    }
+    CloseFile(&file);
+}
+
+/**
+ * @brief Counts the lines of the file the way the game did before the dictionary.
+ *
+ * @param filename Name of the word file.
+ * @return The number of lines.
+ */
+size_t OldCountWordsInFile(const char *filename) {
+    FILE *file; char line[OLD_MAX_LENGTH]; size_t lines = 0;
+    FileOpenError(&file, filename, "r");
+    while (fgets(line, sizeof(line), file) != NULL) {
+        lines++;
+    }
+    fclose(file);
+    return lines;
+}
+
+/**
+ * @brief Selects a word by reading the file up to a line, as the game did before the dictionary.
+ *
+ * @param filename Name of the word file.
+ * @param line Index of the line to select.
+ * @param selectedword Buffer to store the selected word.
+ */
+void OldSelectWord(const char *filename, size_t line, char selectedword[OLD_MAX_LENGTH]) {
+    FILE *file;
+    FileOpenError(&file, filename, "r");
+    for (size_t i = 0; i <= line; i++) {
+        if (fgets(selectedword, OLD_MAX_LENGTH, file) == NULL) {
+            break;
+        }
+    }
+    fclose(file);
+    selectedword[strcspn(selectedword, "\n")] = 0;
+}
+
+/**
+ * @brief Looks for a word by scanning the file, as the game did before the hash index.
+ *
+ * @param filename Name of the word file.
+ * @param word The word to look for.
+ * @return true if the word is in the file, false otherwise.
+ */
+bool OldWordAlreadyInFile(const char *filename, const char *word) {
+    FILE *file; char line[OLD_MAX_LENGTH]; bool found = false;
+    FileOpenError(&file, filename, "r");
+    while (!found && fgets(line, sizeof(line), file) != NULL) {
+        line[strcspn(line, "\n")] = 0;
+        found = strcmp(line, word) == 0;
+    }
+    fclose(file);
+    return found;
+}
+
+/**
+ * @brief Resolves a guess by looping over the whole buffer, as the game did before the letter table.
+ *
+ * @param WordToGuess The word to be guessed.
+ * @param board The board, updated with the guessed letter.
+ * @param letter The guessed letter.
+ * @return true if the letter is in the word, false otherwise.
+ */
+bool OldResolveGuess(const char WordToGuess[OLD_MAX_LENGTH], char board[OLD_MAX_LENGTH], char letter) {
+    bool found = false;
+    for (int i = 0; i < OLD_MAX_LENGTH; i++) {
+        if (WordToGuess[i] == letter) {
+            board[i] = letter;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Validates a word with `strlen` in the loop condition and `isalpha`, as the game did before the lookup table.
+ *
+ * @param word The null-terminated word.
+ * @return true if the word is valid, false otherwise.
+ */
+bool OldIsValidWord(const char *word) {
+    if (strlen(word) < 2) {
+        return false;
+    }
+    for (size_t i = 0; i < strlen(word); i++) {
+        if (!isalpha(word[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Suggests a letter by filtering the whole dictionary, as a solver without an index would.
+ *
+ * @param dict The dictionary.
+ * @param game The game in progress.
+ * @return The unguessed letter most words that fit the board contain.
+ */
+char OldHint(const Dictionary *dict, const Game *game) {
+    uint32_t frequencies[26] = { 0 };
+    const char *board = GameBoard(game);
+    for (size_t i = 0; i < dict->count; i++) {
+        const char *word = DictionaryWord(dict, i);
+        bool fits = DictionaryWordLength(dict, i) == game->length;
+        uint32_t letters = 0;
+        for (size_t j = 0; fits && j < game->length; j++) {
+            int letter = tolower((unsigned char)word[j]) - 'a';
+            bool guessed = letter >= 0 && letter < 26 && (game->guessed & ((uint32_t)1 << letter));
+            fits = board[j] == '_' ? !guessed : tolower((unsigned char)board[j]) == tolower((unsigned char)word[j]);
+            letters |= letter >= 0 && letter < 26 ? (uint32_t)1 << letter : 0;
+        }
+        for (int letter = 0; fits && letter < 26; letter++) {
+            frequencies[letter] += (letters >> letter) & 1;
+        }
+    }
+    int best = 0;
+    for (int letter = 1; letter < 26; letter++) {
+        if (!(game->guessed & ((uint32_t)1 << letter)) && frequencies[letter] > frequencies[best]) {
+            best = letter;
+        }
+    }
+    return (char)('a' + best);
+}
+
+/**
+ * @brief Runs all benchmarks on a synthetic dictionary of the given size.
+ *
+ * @param words Number of words in the dictionary.
+ * @param rng Generator for the words and the selections.
+ */
+void BenchDictionary(size_t words, Rng *rng) {
+    Dictionary dict;
+    char word[MAX_LENGTH];
+    uint64_t start, ops, sink = 0;
+
+    BenchGenerate(BENCH_FILENAME, words, rng);
+
+    // Loading: counting lines of the file against loading the dictionary once
+    ops = BenchScans(words, 20);
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        sink += OldCountWordsInFile(BENCH_FILENAME);
+    }
+    BenchReport("count/old fgets scan", words, ops, NowNanoseconds() - start);
+
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        DictionaryInit(&dict);
+        DictionaryLoad(&dict, BENCH_FILENAME);
+        sink += CountWordsInFile(&dict);
+        DictionaryFree(&dict);
+    }
+    BenchReport("load/text dictionary", words, ops, NowNanoseconds() - start);
+
+    DictionaryInit(&dict);
+    DictionaryLoad(&dict, BENCH_FILENAME);
+    DictionaryCompile(&dict, BENCH_COMPILED, NULL);
+    ops = 1000;
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        Dictionary compiled;
+        DictionaryInit(&compiled);
+        DictionaryLoadCompiled(&compiled, BENCH_COMPILED, NULL);
+        sink += CountWordsInFile(&compiled);
+        DictionaryFree(&compiled);
+    }
+    BenchReport("load/compiled dictionary", words, ops, NowNanoseconds() - start);
+
+    // Heap of every process when the words are mapped from the compiled file and a few are added
+    Dictionary mapped;
+    DictionaryInit(&mapped);
+    DictionaryLoadCompiled(&mapped, BENCH_COMPILED, NULL);
+    for (size_t i = 0; i < 100; i++) {
+        size_t length = 14 + RngBounded(rng, 10);   // Longer than the generated words, so they are all new
+        for (size_t j = 0; j < length; j++) {
+            word[j] = (char)('a' + RngBounded(rng, 26));
+        }
+        DictionaryAdd(&mapped, word, length);
+    }
+    printf("%-32s %11zu words %14.1f bytes/word %11.1f mapped\n", "shared/private memory", words,
+           (double)BenchDictionaryBytes(&dict) / (double)dict.count, (double)BenchDictionaryBytes(&mapped) / (double)mapped.count);
+    ops = 1000000;
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        size_t index = RngBounded(rng, mapped.count);
+        sink += DictionaryContains(&mapped, DictionaryWord(&mapped, index), DictionaryWordLength(&mapped, index));
+    }
+    BenchReport("shared/dedupe mapped", words, ops, NowNanoseconds() - start);
+    DictionaryFree(&mapped);
+
+    // Selection
+    ops = BenchScans(words, 20);
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        OldSelectWord(BENCH_FILENAME, RngBounded(rng, words), word);
+        sink += word[0];
+    }
+    BenchReport("select/old file rescan", words, ops, NowNanoseconds() - start);
+
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        SelectWordStreaming(BENCH_FILENAME, rng, NULL, word);
+        sink += word[0];
+    }
+    BenchReport("select/reservoir stream", words, ops, NowNanoseconds() - start);
+
+    ops = 1000000;
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        SelectWord(&dict, rng, dict.count, word);
+        sink += word[0];
+    }
+    BenchReport("select/dictionary", words, ops, NowNanoseconds() - start);
+
+    WordFilter filter = { 7, DIFFICULTY_HARD };
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        sink += SelectWordMatching(&dict, rng, &filter, word);
+    }
+    BenchReport("select/bucket 7 letters hard", words, ops, NowNanoseconds() - start);
+
+    // Duplicate checks, of words that are in the dictionary
+    ops = BenchScans(words, 20);
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        sink += OldWordAlreadyInFile(BENCH_FILENAME, DictionaryWord(&dict, RngBounded(rng, dict.count)));
+    }
+    BenchReport("dedupe/old file scan", words, ops, NowNanoseconds() - start);
+
+    ops = 1000000;
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        size_t index = RngBounded(rng, dict.count);
+        sink += DictionaryContains(&dict, DictionaryWord(&dict, index), DictionaryWordLength(&dict, index));
+    }
+    BenchReport("dedupe/hash index", words, ops, NowNanoseconds() - start);
+
+    // The same dictionary compacted into sorted front-coded blocks
+    Dictionary compact;
+    DictionaryInit(&compact);
+    DictionaryLoad(&compact, BENCH_FILENAME);
+    start = NowNanoseconds();
+    DictionaryCompact(&compact);
+    BenchReport("compact/front-code", words, 1, NowNanoseconds() - start);
+    printf("%-32s %11zu words %14.1f bytes/word %11.1f compacted\n", "compact/memory", words,
+           (double)BenchDictionaryBytes(&dict) / (double)dict.count, (double)BenchDictionaryBytes(&compact) / (double)compact.count);
+
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        size_t index = RngBounded(rng, compact.count);
+        memcpy(word, DictionaryWord(&compact, index), DictionaryWordLength(&compact, index) + 1);
+        sink += DictionaryContains(&compact, word, DictionaryWordLength(&compact, index));
+    }
+    BenchReport("compact/dedupe blocks", words, ops, NowNanoseconds() - start);
+
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        SelectWord(&compact, rng, compact.count, word);
+        sink += word[0];
+    }
+    BenchReport("compact/select by rank", words, ops, NowNanoseconds() - start);
+    DictionaryFree(&compact);
+
+    // Validation of the words of the dictionary
+    ops = 10000000;
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        sink += OldIsValidWord(DictionaryWord(&dict, i % dict.count));
+    }
+    BenchReport("validate/old strlen isalpha", words, ops, NowNanoseconds() - start);
+
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        size_t index = i % dict.count;
+        sink += WordIsValid(DictionaryWord(&dict, index), DictionaryWordLength(&dict, index));
+    }
+    BenchReport("validate/lookup table", words, ops, NowNanoseconds() - start);
+
+    // Adding words: one append per word against one buffered append per batch
+    ops = 1000;
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        FILE *file;
+        FileOpenError(&file, BENCH_FILENAME, "a");
+        fprintf(file, "zz%llu\n", (unsigned long long)i);
+        CloseFile(&file);
+    }
+    BenchReport("insert/old append per word", words, ops, NowNanoseconds() - start);
+
+    start = NowNanoseconds();
+    char *pending = ReallocOrExit(NULL, ops * MAX_LENGTH);
+    size_t pendingSize = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        int length = snprintf(word, sizeof(word), "zy%llu", (unsigned long long)i);
+        if (!DictionaryContains(&dict, word, (size_t)length)) {
+            DictionaryAdd(&dict, word, (size_t)length);
+            memcpy(pending + pendingSize, word, (size_t)length);
+            pending[pendingSize + length] = '\n';
+            pendingSize += (size_t)length + 1;
+        }
+    }
+    FILE *file;
+    FileOpenError(&file, BENCH_FILENAME, "ab");
+    fwrite(pending, 1, pendingSize, file);
+    CloseFile(&file);
+    free(pending);
+    BenchReport("insert/bulk batched", words, ops, NowNanoseconds() - start);
+
+    Journal journal;
+    JournalOpen(&journal, BENCH_JOURNAL, BENCH_FILENAME, NULL);
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        int length = snprintf(word, sizeof(word), "zx%llu", (unsigned long long)i);
+        if (!DictionaryContains(&dict, word, (size_t)length)) {
+            DictionaryAdd(&dict, word, (size_t)length);
+            JournalAppend(&journal, word, (size_t)length);
+        }
+    }
+    JournalCommit(&journal);
+    BenchReport("insert/journal group commit", words, ops, NowNanoseconds() - start);
+    JournalClose(&journal);
+
+    // Guess resolution
+    Game game;
+    char board[OLD_MAX_LENGTH];
+    ops = 10000000;
+    SelectWord(&dict, rng, dict.count, word);
+    memset(word + strlen(word), 0, OLD_MAX_LENGTH - strlen(word));
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        sink += OldResolveGuess(word, board, (char)('a' + i % 26));
+    }
+    BenchReport("guess/old buffer loop", words, ops, NowNanoseconds() - start);
+
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i += 26) {
+        GameStart(&game, word);
+        for (int letter = 0; letter < 26; letter++) {
+            sink += GameGuess(&game, (char)('a' + letter));
+        }
+        GameEnd(&game);
+    }
+    BenchReport("guess/letter table", words, ops, NowNanoseconds() - start);
+
+    // Hints: the whole dictionary per hint against the candidates the solver has left
+    ops = BenchScans(words, 100);
+    start = NowNanoseconds();
+    for (uint64_t i = 0; i < ops; i++) {
+        SelectWord(&dict, rng, dict.count, word);
+        GameStart(&game, word);
+        GameGuess(&game, 'e');
+        sink += OldHint(&dict, &game);
+        GameEnd(&game);
+    }
+    BenchReport("hint/old dictionary scan", words, ops, NowNanoseconds() - start);
+
+    SolverIndex index;
+    Solver solver;
+    Dictionary *shards[1] = { &dict };
+    SolverIndexInit(&index);
+    start = NowNanoseconds();
+    SolverIndexBuild(&index, shards, 1);
+    BenchReport("hint/solver index build", words, 1, NowNanoseconds() - start);
+    SolverInit(&solver, &index);
+    ops = 0;
+    uint64_t games = 10000, elapsed = 0;
+    for (uint64_t i = 0; i < games; i++) {
+        ParsedGuess guess;
+        SelectWord(&dict, rng, dict.count, word);
+        GameStart(&game, word);
+        SolverStart(&solver, &game);
+        while (!GameIsWon(&game) && !GameIsLost(&game)) {
+            start = NowNanoseconds();
+            SolverNextGuess(&solver, &game, &guess);
+            elapsed += NowNanoseconds() - start;
+            ops++;
+            sink += GameApplyGuess(&game, &guess);
+        }
+        GameEnd(&game);
+    }
+    BenchReport("hint/solver per guess", words, ops, elapsed);
+    SolverFree(&solver);
+    SolverIndexFree(&index);
+
+    // Results of finished games, one player per 100 words
+    PlayerStore players;
+    char name[PLAYER_NAME_MAX + 1];
+    PlayerStoreOpen(&players, BENCH_FILENAME);
+    ops = 1000000;
+    elapsed = 0;
+    uint64_t flushing = 0;
+    for (uint64_t i = 0; i < ops; i++) {
+        snprintf(name, sizeof(name), "player%zu", (size_t)RngBounded(rng, words / 100 + 1));
+        start = NowNanoseconds();
+        bool full = PlayerStoreRecord(&players, name, i % 3 != 0, i % MAX_WRONG_GUESSES);
+        elapsed += NowNanoseconds() - start;
+        if (full) {
+            start = NowNanoseconds();
+            PlayerStoreFlush(&players);
+            flushing += NowNanoseconds() - start;
+        }
+    }
+    BenchReport("players/record result", words, ops, elapsed);
+    BenchReport("players/flush per result", words, ops, flushing);
+    start = NowNanoseconds();
+    PlayerStats top[PLAYER_TOP];
+    sink += PlayerStoreTop(&players, top, PLAYER_TOP);
+    BenchReport("players/leaderboard", words, 1, NowNanoseconds() - start);
+    PlayerStoreClose(&players);
+    remove(BENCH_PLAYERS);
+    remove(BENCH_RESULTS);
+
+    DictionaryFree(&dict);
+    remove(BENCH_FILENAME);
+    remove(BENCH_COMPILED);
+    remove(BENCH_JOURNAL);
+    BenchSink = sink;
+    printf("\n");
+}
+
+/**
+ * @brief Runs the benchmarks for every dictionary size given on the command line.
+ *
+ * Without arguments, dictionaries of 10K, 100K and 1M words are used. Larger
+ * sizes, up to 100M words, can be given explicitly.
+ */
+int main(int argc, char *argv[]) {
+    Rng rng;
+    RngSeed(&rng, 42);
+    StatsEnabled = false;   // Measure the code paths without the instrumentation
+    if (argc < 2) {
+        BenchDictionary(10000, &rng);
+        BenchDictionary(100000, &rng);
+        BenchDictionary(1000000, &rng);
+    }
+    for (int i = 1; i < argc; i++) {
+        BenchDictionary((size_t)strtoull(argv[i], NULL, 10), &rng);
+    }
+    return 0;
+}
@@ -4,8 +4,337 @@
 #include <stdbool.h>
 #include <ctype.h>
 #include <time.h>
-#define MAX_LENGTH 40
+#include <errno.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define HANGMAN_POSIX
+#define HANGMAN_HAVE_MMAP
+#define HANGMAN_HAVE_THREADS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <pthread.h>
+#endif
+#define MAX_LENGTH 1024
 #define FILENAME "WordstoGuess.txt"
+#define COMPILED_EXTENSION ".bin"
+#define CATALOG_MAX_SHARDS 64
+#define LOAD_MAX_THREADS 64
+#define LOAD_CHUNK_MIN (1 << 20)
+
+/**
+ * @brief Returns a monotonic timestamp for measuring durations.
+ * 
+ * @return Nanoseconds since an arbitrary, fixed point in time.
+ */
+uint64_t NowNanoseconds(void) {
+    struct timespec now;
+#ifdef HANGMAN_POSIX
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#else
+    timespec_get(&now, TIME_UTC);
+#endif
+    return (uint64_t)now.tv_sec * 1000000000ULL + (uint64_t)now.tv_nsec;
+}
+
+/**
+ * @brief Returns the position of the highest set bit.
+ * 
+ * @param bits The bits to search, must not be 0.
+ * @return Position of the highest set bit.
+ */
+int HighestBit(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(bits);
+#else
+    int position = 0;
+    while (bits >>= 1) {
+        position++;
+    }
+    return position;
+#endif
+}
+
+/**
+ * @brief Hot paths measured by the instrumentation.
+ */
+typedef enum {
+    STAT_FILE_OPEN,         // Opening files in FileOpenError
+    STAT_FILE_CLOSE,        // Closing files in CloseFile
+    STAT_DICTIONARY_SCAN,   // Reading through a whole word file
+    STAT_SELECT,            // Selecting a random word
+    STAT_GUESS,             // Resolving a guess
+    STAT_RENDER,            // Rendering a frame of the game
+    STAT_BOARD,             // Building the board and letter table of a new game
+    STAT_KINDS
+} StatKind;
+
+#define STAT_BUCKETS 40
+
+/**
+ * @brief Number of calls and latency histogram of one hot path.
+ * 
+ * Bucket `i` counts the calls that took from 2^i to 2^(i+1) - 1 nanoseconds.
+ * The fields are only written by the thread that owns them, so relaxed
+ * atomic loads and stores are enough and no read-modify-write is needed.
+ */
+typedef struct {
+    atomic_uint_fast64_t count;                 // Number of calls
+    atomic_uint_fast64_t total;                 // Nanoseconds of all calls
+    atomic_uint_fast64_t max;                   // Nanoseconds of the slowest call
+    atomic_uint_fast64_t buckets[STAT_BUCKETS]; // Latency histogram
+} StatCounter;
+
+#define TRACE_BUFFER 4096
+
+/**
+ * @brief One phase recorded for the trace written by `--profile`.
+ */
+typedef struct {
+    const char *name;       // Name of the phase, a string constant
+    uint64_t start;         // NowNanoseconds at the start
+    uint64_t duration;      // Nanoseconds the phase took
+    bool instant;           // A point in time rather than a phase
+    const char *argument;   // Name of the argument, a string constant, or NULL
+    int64_t value;          // Value of the argument
+} TraceEvent;
+
+/**
+ * @brief Counters of one thread, linked into the list of all threads.
+ * 
+ * The counters of a thread stay in the list after the thread has ended, so
+ * their calls remain part of the merged totals. With `--profile` the thread
+ * also keeps the phases it recorded and not written to the trace yet.
+ */
+typedef struct ThreadStats {
+    StatCounter counters[STAT_KINDS];
+    struct ThreadStats *next;
+    uint32_t id;                // Number of the thread in the trace
+    TraceEvent *events;         // TRACE_BUFFER phases, allocated when tracing
+    size_t eventCount;          // Phases in events
+} ThreadStats;
+
+const char *const StatNames[STAT_KINDS] = {
+    "file open", "file close", "dictionary scan", "select word", "guess", "render", "board build"
+};
+
+/**
+ * @brief Whether hot paths are measured, cleared by `--no-stats`.
+ */
+bool StatsEnabled = true;
+
+ThreadStats *_Atomic StatsThreads = NULL;
+_Thread_local ThreadStats *LocalStats = NULL;
+atomic_uint StatsThreadIds = 0;
+
+/**
+ * @brief Trace the phases are written to, set by `--profile`, NULL when not tracing.
+ * 
+ * Set before any other thread starts and cleared after they all ended.
+ */
+FILE *TraceFile = NULL;
+uint64_t TraceOrigin = 0;       // NowNanoseconds when tracing started, time 0 of the trace
+atomic_flag TraceWriting = ATOMIC_FLAG_INIT;
+
+/**
+ * @brief Returns the counters of the calling thread.
+ * 
+ * On the first call of a thread its counters are allocated and pushed onto
+ * the list of all threads without taking a lock.
+ * 
+ * @return The counters, or NULL if they could not be allocated.
+ */
+ThreadStats *StatsLocal(void) {
+    if (LocalStats == NULL) {
+        LocalStats = calloc(1, sizeof(ThreadStats));
+        if (LocalStats == NULL) {
+            return NULL;
+        }
+        LocalStats->id = atomic_fetch_add(&StatsThreadIds, 1);
+        LocalStats->next = atomic_load(&StatsThreads);
+        while (!atomic_compare_exchange_weak(&StatsThreads, &LocalStats->next, LocalStats));
+    }
+    return LocalStats;
+}
+
+/**
+ * @brief Writes the phases a thread recorded to the trace and forgets them.
+ * 
+ * Threads take turns writing with a spin lock, which is only held while
+ * a full buffer of phases is formatted.
+ * 
+ * @param thread The thread, which must be the calling one or have ended.
+ */
+void TraceWriteEvents(ThreadStats *thread) {
+    if (TraceFile == NULL || thread->eventCount == 0) {
+        return;
+    }
+    while (atomic_flag_test_and_set_explicit(&TraceWriting, memory_order_acquire));
+    for (size_t i = 0; i < thread->eventCount; i++) {
+        const TraceEvent *event = &thread->events[i];
+        fprintf(TraceFile, "{\"name\":\"%s\",\"cat\":\"hangman\",\"ph\":\"%s\",\"ts\":%.3f,",
+                event->name, event->instant ? "i" : "X", (double)(event->start - TraceOrigin) / 1000.0);
+        if (event->instant) {
+            fputs("\"s\":\"t\",", TraceFile);
+        } else {
+            fprintf(TraceFile, "\"dur\":%.3f,", (double)event->duration / 1000.0);
+        }
+        fprintf(TraceFile, "\"pid\":1,\"tid\":%u", thread->id);
+        if (event->argument != NULL) {
+            fprintf(TraceFile, ",\"args\":{\"%s\":%lld}", event->argument, (long long)event->value);
+        }
+        fputs("},\n", TraceFile);
+    }
+    fflush(TraceFile);
+    atomic_flag_clear_explicit(&TraceWriting, memory_order_release);
+    thread->eventCount = 0;
+}
+
+/**
+ * @brief Keeps an event in the buffer of the calling thread.
+ * 
+ * The buffer is written once it is full or the thread calls `TraceFlush`.
+ * 
+ * @param event The event.
+ */
+void TraceAppend(const TraceEvent *event) {
+    ThreadStats *thread;
+    if (TraceFile == NULL || (thread = StatsLocal()) == NULL) {
+        return;
+    }
+    if (thread->events == NULL && (thread->events = malloc(TRACE_BUFFER * sizeof(TraceEvent))) == NULL) {
+        return;
+    }
+    thread->events[thread->eventCount++] = *event;
+    if (thread->eventCount == TRACE_BUFFER) {
+        TraceWriteEvents(thread);
+    }
+}
+
+/**
+ * @brief Records a phase of the calling thread for the trace.
+ * 
+ * @param name Name of the phase, a string constant.
+ * @param start NowNanoseconds at the start of the phase.
+ * @param end NowNanoseconds at the end of the phase.
+ * @param argument Name of an argument shown with the phase, a string constant, or NULL.
+ * @param value Value of the argument.
+ */
+void TraceEventAdd(const char *name, uint64_t start, uint64_t end, const char *argument, int64_t value) {
+    TraceEvent event = { .name = name, .start = start, .duration = end - start, .argument = argument, .value = value };
+    TraceAppend(&event);
+}
+
+/**
+ * @brief Records a point in time of the calling thread for the trace, e.g. the first prompt.
+ * 
+ * @param name Name of the point, a string constant.
+ */
+void TraceMark(const char *name) {
+    if (TraceFile != NULL) {
+        TraceEvent event = { .name = name, .start = NowNanoseconds(), .instant = true };
+        TraceAppend(&event);
+    }
+}
+
+/**
+ * @brief Writes the phases recorded by the calling thread so far, e.g. after every game.
+ */
+void TraceFlush(void) {
+    if (TraceFile != NULL && LocalStats != NULL) {
+        TraceWriteEvents(LocalStats);
+    }
+}
+
+/**
+ * @brief Starts measuring a hot path.
+ * 
+ * @return The start time, or 0 if neither measuring nor tracing is enabled.
+ */
+uint64_t StatStart(void) {
+    return StatsEnabled || TraceFile != NULL ? NowNanoseconds() : 0;
+}
+
+/**
+ * @brief Records one call of a hot path in the counters of the calling thread.
+ * 
+ * With `--profile` the call is also recorded as a phase of the trace.
+ * 
+ * @param kind The hot path.
+ * @param start Value returned by `StatStart` when the call began.
+ */
+void StatStop(StatKind kind, uint64_t start) {
+    if (!StatsEnabled && TraceFile == NULL) {
+        return;
+    }
+    uint64_t now = NowNanoseconds(), elapsed = now - start;
+    if (TraceFile != NULL) {
+        TraceEventAdd(StatNames[kind], start, now, NULL, 0);
+    }
+    ThreadStats *local;
+    if (!StatsEnabled || (local = StatsLocal()) == NULL) {
+        return;
+    }
+    StatCounter *counter = &local->counters[kind];
+    int bucket = HighestBit(elapsed | 1);
+    bucket = bucket < STAT_BUCKETS ? bucket : STAT_BUCKETS - 1;
+    atomic_store_explicit(&counter->count, atomic_load_explicit(&counter->count, memory_order_relaxed) + 1, memory_order_relaxed);
+    atomic_store_explicit(&counter->total, atomic_load_explicit(&counter->total, memory_order_relaxed) + elapsed, memory_order_relaxed);
+    if (elapsed > atomic_load_explicit(&counter->max, memory_order_relaxed)) {
+        atomic_store_explicit(&counter->max, elapsed, memory_order_relaxed);
+    }
+    atomic_store_explicit(&counter->buckets[bucket], atomic_load_explicit(&counter->buckets[bucket], memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the upper bound of the histogram bucket holding a percentile.
+ * 
+ * @param buckets The merged histogram.
+ * @param count Number of calls in the histogram.
+ * @param percentile The percentile, from 0 to 100.
+ * @return Upper bound of the bucket in nanoseconds.
+ */
+uint64_t StatPercentile(const uint64_t buckets[STAT_BUCKETS], uint64_t count, unsigned percentile) {
+    uint64_t rank = (count * percentile + 99) / 100, seen = 0;
+    if (count == 0) {
+        return 0;
+    }
+    for (int i = 0; i < STAT_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return ((uint64_t)2 << i) - 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Prints the counters of all threads merged into one table.
+ * 
+ * @param out The file to print to.
+ */
+void StatsPrint(FILE *out) {
+    fprintf(out, "%-16s %12s %12s %12s %12s %12s\n", "hot path", "calls", "avg ns", "p50 ns", "p99 ns", "max ns");
+    for (int kind = 0; kind < STAT_KINDS; kind++) {
+        uint64_t count = 0, total = 0, max = 0, buckets[STAT_BUCKETS] = {0};
+        for (ThreadStats *thread = atomic_load(&StatsThreads); thread != NULL; thread = thread->next) {
+            StatCounter *counter = &thread->counters[kind];
+            count += atomic_load_explicit(&counter->count, memory_order_relaxed);
+            total += atomic_load_explicit(&counter->total, memory_order_relaxed);
+            uint64_t slowest = atomic_load_explicit(&counter->max, memory_order_relaxed);
+            max = slowest > max ? slowest : max;
+            for (int i = 0; i < STAT_BUCKETS; i++) {
+                buckets[i] += atomic_load_explicit(&counter->buckets[i], memory_order_relaxed);
+            }
+        }
+        fprintf(out, "%-16s %12llu %12llu %12llu %12llu %12llu\n", StatNames[kind], (unsigned long long)count,
+                (unsigned long long)(count ? total / count : 0), (unsigned long long)StatPercentile(buckets, count, 50),
+                (unsigned long long)StatPercentile(buckets, count, 99), (unsigned long long)max);
+    }
+    fflush(out);
+}
 
 /**
  * @brief Handles errors that may occur while opening a file.
@@ -16,7 +345,9 @@
  * @param file Pointer to the file to be checked for opening errors.
  */
 void FileOpenError(FILE **file, const char *filename, const char *mode) {
+    uint64_t start = StatStart();
     *file = fopen(filename, mode);
+    StatStop(STAT_FILE_OPEN, start);
     if (*file == NULL) {
         perror("Error opening file");
         exit(1);
@@ -38,408 +369,4617 @@ void FileOpenError(FILE **file, const char *filename, const char *mode) {
 void CloseFile(FILE **file) {
     // Check if the file pointer is not NULL, meaning the file is currently open
     if (*file != NULL) {
+        uint64_t start = StatStart();
         fclose(*file); // Close the file to release resources
+        StatStop(STAT_FILE_CLOSE, start);
         *file = NULL; // Set the file pointer to NULL to prevent double closing
     }
 }
 
 /**
- * @brief Handles the case when a file is empty or an error occurs while reading it.
+ * @brief Starts writing a trace of the phases of the program, for `--profile`.
  * 
- * If the file is empty, a message indicating the end of the file is reached is printed.
- * If an error occurs while reading the file, an error message is printed using perror.
+ * The trace is a JSON array of Chrome trace events, which chrome://tracing
+ * and Perfetto open directly; time 0 is the call of this function. A trace
+ * cut short by a crash can still be opened, as the viewers accept an array
+ * that is not closed.
  * 
- * @param filename Name of the file to be checked for emptiness or read errors.
- * @param mode Mode in which the file should be opened.
- * @param line Buffer to store the read line from the file.
- * @return true if the file is empty, false otherwise.
+ * @param filename Name of the trace file.
  */
-bool FileEmpty(const char *filename, const char *mode, char *line) {
+void TraceOpen(const char *filename) {
     FILE *file;
-    FileOpenError(&file, filename, mode);
-
-    if (fgets(line, sizeof(line), file) == NULL) {
-        if (feof(file)) {
-            printf("End of file reached.\n");
-            fclose(file);
-            return true;
-        } else if (ferror(file)) {
-            perror("Error reading file");
-            fclose(file);
-            return true;
-        } else {
-            printf("An unknown error occurred.\n");
-            fclose(file);
-            return true;
-        }
-    }
-
-    fclose(file);
-    return false;
+    FileOpenError(&file, filename, "w");
+    fputs("[\n", file);
+    TraceOrigin = NowNanoseconds();
+    TraceFile = file;
 }
 
 /**
- * @brief Checks if a given word already exists in the specified file.
+ * @brief Writes the phases of all threads that are left and closes the trace.
  * 
- * Opens the file for reading and searches for the word. If the word is found,
- * prints a message indicating that the word is already in the file.
- * 
- * @param filename The name of the file to be checked.
- * @param word The word to search for in the file.
- * @return true if the word is found, false otherwise.
+ * Every other thread that recorded phases must have ended.
  */
-bool WordAlreadyInFile(const char *filename, const char *word) {
-    FILE *file;
-    char line[MAX_LENGTH];
-    bool found = false;
-
-    FileOpenError(&file, FILENAME, "r");
-
-    while (fgets(line, sizeof(line), file) != NULL) {
-        line[strcspn(line, "\n")] = 0;
-        // Check if the line matches the word
-        if (strcmp(line, word) == 0) {
-            found = true;
-            break;
-        }
+void TraceClose(void) {
+    if (TraceFile == NULL) {
+        return;
     }
-    fclose(file);
-    if (found) {
-        printf("The word '%s' is already in the file.\n", word);
+    for (ThreadStats *thread = atomic_load(&StatsThreads); thread != NULL; thread = thread->next) {
+        TraceWriteEvents(thread);
     }
-    return found;
+    FILE *file = TraceFile;
+    TraceFile = NULL;   // Closing the file is not traced anymore
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Hangman\"}}\n]\n", file);
+    if (ferror(file)) {
+        perror("Error writing file");
+        exit(1);
+    }
+    CloseFile(&file);
 }
 
 /**
- * @brief Validates if the input is a real word.
- * 
- * This function checks if the provided word meets certain criteria to be considered valid. 
- * A valid word must be non-empty and contain only alphabetic characters. The function
- * ensures that the word is at least a specified length and does not contain any invalid
- * characters.
+ * @brief Reads one line from the file into the buffer, without the newline.
  * 
- * @param word The word to be validated. It should be a null-terminated string.
+ * Unlike a plain `fgets`, a line that does not fit into the buffer is consumed
+ * completely instead of being returned as several pieces. A line of exactly
+ * `size - 1` characters fits, even though its line break does not.
  * 
- * @return true if the word is valid, false otherwise.
+ * @param file The file to read from.
+ * @param line Buffer to store the line.
+ * @param size Size of the buffer.
+ * @param truncated Set to true if the line was longer than the buffer.
+ * @return true if a line was read, false at the end of the file.
  */
-bool IsValidWord(const char *word) {
-    // Check if the word is non-empty and contains only alphabetic characters
-    if (strlen(word) < 2) {
-        printf("Invalid word %s\n", word);
+bool ReadLine(FILE *file, char *line, size_t size, bool *truncated) {
+    *truncated = false;
+    if (fgets(line, (int)size, file) == NULL) {
         return false;
     }
-    for (size_t i = 0; i < strlen(word); i++) {
-        if (!isalpha(word[i])) {
-            printf("Invalid word %s\n", word);
-            return false; // Invalid character found
+    size_t length = strcspn(line, "\n");
+    if (line[length] != '\n' && !feof(file)) {
+        // A full buffer is only truncated if more than the line break follows
+        int ch = fgetc(file);
+        if (ch == '\r') {
+            ch = fgetc(file);
         }
+        *truncated = ch != '\n' && ch != EOF;
+        // Skip the rest of an overlong line
+        while (*truncated && ch != '\n' && ch != EOF) {
+            ch = fgetc(file);
+        }
+    }
+    line[length] = 0;
+    if (length > 0 && line[length - 1] == '\r') {
+        line[length - 1] = 0;
     }
     return true;
 }
 
 /**
- * @brief Allows the user to insert words into the file, handling input until the user enters "0".
+ * @brief Checks whether the file is empty or its last byte is a newline.
  * 
- * This function continuously prompts the user to input words, which are then added to the file.
- * The user can stop the insertion process by entering "0". The function also checks for empty input
- * and ensures that only non-empty words are added to the file.
+ * Used before appending to the word file, so a missing newline at the end of
+ * the file does not glue the first appended word to the last existing one.
  * 
- * @param file Pointer to the file where words will be added. The file must be opened in append mode.
- * @param line Buffer to store the input word from the user.
+ * @param filename Name of the file to check.
+ * @return true if words can be appended as they are, false if a newline is needed first.
  */
-void WordInsertion (FILE *file, char *line){
-    printf("Please enter the word you want to add: ");
-    while (fgets(line, MAX_LENGTH, stdin) != 0)
-    { 
-        line[strcspn(line, "\n")] = 0;
-        if (strcmp(line, "0") == 0)
-        {
-            break;
-        }
-        if(!IsValidWord(line)){
-            return;
-        }
-        FileOpenError(&file, FILENAME, "a");
-        if (!WordAlreadyInFile(FILENAME, line))
-        {
-            fprintf(file, "%s\n", line);
-            printf("Word %s has been added.\n", line);
+bool FileEndsWithNewline(const char *filename) {
+    FILE *file = fopen(filename, "rb");
+    bool ends = true;
+    if (file != NULL) {
+        if (fseek(file, -1, SEEK_END) == 0) {
+            ends = fgetc(file) == '\n';
         }
-        else if( strlen(line) <= 0)
-        {
-            printf("Invalid word. Please enter a non-empty word.\n");
-        }
-        printf("If you want to continue adding write the words. Otherwise 0: ");
-        CloseFile(&file);
+        fclose(file);
     }
+    return ends;
 }
 
 /**
- * @brief Counts the total number of lines in the given file.
+ * @brief Reallocates a block of memory, exiting the program if it fails.
  * 
- * This function reads through the file line by line, incrementing a counter for each line encountered.
- * The file is expected to be open before passing it to this function. The function returns the total 
- * number of lines found in the file.
+ * Works like `realloc`, but in the same way as `FileOpenError` the program
+ * prints an error message using perror and exits with an exit code of 1 when
+ * the memory cannot be allocated, so callers never have to handle NULL.
  * 
- * @param file Pointer to the open file where the lines are to be counted. 
- * 
- * @return The total number of lines in the file.
+ * @param ptr Block to resize, or NULL to allocate a new one.
+ * @param size New size of the block in bytes.
+ * @return Pointer to the resized block.
  */
-int CountWordsInFile(FILE *file){
-    int NumOfLines = 0; char line[MAX_LENGTH];
-    while (fgets(line, sizeof(line), file) != NULL) {
-        NumOfLines++;
+void *ReallocOrExit(void *ptr, size_t size) {
+    void *resized = realloc(ptr, size);
+    if (resized == NULL && size != 0) {
+        perror("Error allocating memory");
+        exit(1);
     }
-    return NumOfLines;
+    return resized;
 }
 
 /**
- * @brief Prints the current state of the hangman based on the number of incorrect guesses.
+ * @brief State of the xoshiro256** pseudo random number generator.
+ * 
+ * Much faster than `rand`, produces full 64-bit numbers and can be seeded
+ * with a fixed value to make the selected words reproducible.
+ */
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+/**
+ * @brief Seeds the generator from a single number.
  * 
- * This function displays an ASCII art representation of the hangman, with different stages
- * corresponding to the number of incorrect guesses made by the player. The final state indicates
- * that the game is over.
+ * The four state words are derived from the seed with splitmix64, so any
+ * seed, including 0, results in a well mixed state.
  * 
- * @param state The current number of incorrect guesses (ranging from 0 to 6).
+ * @param rng The generator to seed.
+ * @param seed The seed.
  */
-void PrintState(int state) {  // ASCII art by ChatGPT <33
-    switch (state) {
-        case 0:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("==========\n");
-            break;
-        case 1:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("   O   |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("=========\n");
-            break;
-        case 2:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("   O   |\n");
-            printf("   |   |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("==========\n");
-            break;
-        case 3:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("   O   |\n");
-            printf("  /|   |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("==========\n");
-            break;
-        case 4:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("   O   |\n");
-            printf("  /|\\  |\n");
-            printf("       |\n");
-            printf("       |\n");
-            printf("==========\n");
-            break;
-        case 5:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("   O   |\n");
-            printf("  /|\\  |\n");
-            printf("  /    |\n");
-            printf("       |\n");
-            printf("==========\n");
-            break;
-        case 6:
-            printf("   +---+\n");
-            printf("   |   |\n");
-            printf("   O   |\n");
-            printf("  /|\\  |\n");
-            printf("  / \\  |\n");
-            printf("       |\n");
-            printf("==========\n\n");
-            break;
+void RngSeed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        rng->s[i] = z ^ (z >> 31);
     }
 }
 
 /**
- * @brief Prompts the user to enter a single letter and checks if it's valid.
- * 
- * This function reads a single character from the user input using `fgetc`, 
- * then checks if the input is a valid alphabetic letter (A-Z or a-z). It also 
- * ensures that no extra characters (like newline or multiple characters) are entered.
+ * @brief Returns a seed that differs between runs, even within the same second.
  * 
- * @return The valid letter entered by the user, or '\0'  if the input was invalid.
+ * @return A seed mixed from the current time, the processor time and the stack address.
  */
-char GetValidLetter() {
-    char ch;    int extra;
-    ch = fgetc(stdin);
+uint64_t RngDefaultSeed(void) {
+    int local;
+    return (uint64_t)time(NULL) * 0x9E3779B97F4A7C15ULL ^ (uint64_t)clock() << 32 ^ (uint64_t)(uintptr_t)&local;
+}
 
-    if (isalpha(ch)) {
-        // Check if there are any extra characters
-        extra = fgetc(stdin);
-        if (extra != '\n' && extra != EOF) {
-            while (fgetc(stdin) != '\n' && fgetc(stdin) != EOF);
-            printf("Invalid input. Please enter only one letter.\n");
-            return '\0';  
-        }
-        return ch;  // Return the valid letter
-    } else {
-        while (fgetc(stdin) != '\n' && fgetc(stdin) != EOF);
-        printf("Invalid input. Please enter only one letter.\n");
-        return '\0'; 
-    }
+/**
+ * @brief Returns the next 64-bit number of the generator.
+ * 
+ * @param rng The generator.
+ * @return A uniformly distributed 64-bit number.
+ */
+uint64_t RngNext(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t x = s[1] * 5;
+    uint64_t result = (x << 7 | x >> 57) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = s[3] << 45 | s[3] >> 19;
+    return result;
 }
 
 /**
- * @brief Converts the word to a board with underscores.
+ * @brief Returns a uniformly distributed number lower than the bound.
  * 
- * This function takes a word and replaces each letter in the word with an 
- * underscore (`_`), creating a new string that can be used as the initial
- * display for the hangman game.
+ * Unlike `rand() % bound` there is no bias towards small numbers: with a
+ * 128-bit multiply the multiply-shift method of Lemire is used, otherwise
+ * numbers above the largest multiple of the bound are rejected.
  * 
- * @param WordToGuess The original word to be guessed.
- * @param board The board where each letter of the word is replaced by `_`.
+ * @param rng The generator.
+ * @param bound Upper bound of the result, must not be 0.
+ * @return A number from 0 to bound - 1.
  */
-void ConvertToBoard(const char WordToGuess[], char board[]) {
-    for (int i = 0; i < strlen(WordToGuess); i++) {
-        if (isalpha(WordToGuess[i])) { 
-            board[i] = '_';            // Replace with underscore
-        } else {
-            board[i] = WordToGuess[i]; // Preserve non-alphabetic characters
+uint64_t RngBounded(Rng *rng, uint64_t bound) {
+#ifdef __SIZEOF_INT128__
+    unsigned __int128 m = (unsigned __int128)RngNext(rng) * bound;
+    if ((uint64_t)m < bound) {
+        uint64_t threshold = -bound % bound;
+        while ((uint64_t)m < threshold) {
+            m = (unsigned __int128)RngNext(rng) * bound;
         }
     }
-    board[strlen(WordToGuess)] = '\0'; 
+    return (uint64_t)(m >> 64);
+#else
+    uint64_t threshold = -bound % bound, x;
+    do {
+        x = RngNext(rng);
+    } while (x < threshold);
+    return x % bound;
+#endif
 }
 
 /**
- * @brief Updates the game state based on the player's guess.
- * 
- * This function checks whether the player's guessed letter is present in the 
- * word to be guessed. It updates the board with the correctly guessed letters 
- * and prints the current hangman state. The function also ensures that the 
- * player enters a valid letter.
+ * @brief Read-only view of a whole file in memory.
  * 
- * @param WordToGuess The word that the player is trying to guess.
- * @param board The current state of the guessed word, with unguessed letters 
- *        represented by underscores (_).
- * @param state The current state of the hangman (number of incorrect guesses).
- * @return true if the guessed letter is found in the word, false otherwise.
+ * On platforms with `mmap` the file is mapped directly, so scanning it is
+ * bounded by how fast the pages come in and nothing is copied. Elsewhere the
+ * file is read into a buffer with stdio, which offers the same view.
  */
-bool ResolveState (const char WordToGuess[MAX_LENGTH], char board[MAX_LENGTH], int state){
-    char letter; bool found = false;
+typedef struct {
+    const char *data;   // Contents of the file
+    size_t size;        // Size of the file in bytes
+    bool mapped;        // true if data is a mapping, false if it is a heap buffer
+} MappedFile;
 
-    PrintState(state);
-    if(state > 5){
-        printf("Game Over!\nThe word was %s. \n", WordToGuess);
-        return found;
+/**
+ * @brief Makes the whole file available in memory for reading.
+ * 
+ * Other errors than a missing file are handled like in `FileOpenError`:
+ * an error message is printed using perror and the program exits.
+ * 
+ * @param map The view to fill.
+ * @param filename Name of the file to open.
+ * @return true if the file is available, false if it does not exist.
+ */
+bool MappedFileOpen(MappedFile *map, const char *filename) {
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = false;
+#ifdef HANGMAN_HAVE_MMAP
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        if (errno == ENOENT) {
+            return false;
+        }
+        perror("Error opening file");
+        exit(1);
     }
-
-    printf("Make your guess %s      ", board);
-    do {
-        letter = GetValidLetter();
-    } while (letter == '\0');
-
-    // Check if the letter is in the word
-    for (int i = 0; i < MAX_LENGTH; i++) {
-        if (WordToGuess[i] == letter) {
-            board[i] = letter;
-            found = true;
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        perror("Error reading file");
+        exit(1);
+    }
+    map->size = (size_t)info.st_size;
+    if (map->size > 0) {
+        void *data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            perror("Error mapping file");
+            exit(1);
         }
+        madvise(data, map->size, MADV_SEQUENTIAL);
+        map->data = data;
+        map->mapped = true;
     }
-    return found;
+    close(fd);
+#else
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        if (errno == ENOENT) {
+            return false;
+        }
+        perror("Error opening file");
+        exit(1);
+    }
+    size_t capacity = 4096, read;
+    char *data = ReallocOrExit(NULL, capacity);
+    while ((read = fread(data + map->size, 1, capacity - map->size, file)) > 0) {
+        map->size += read;
+        if (map->size == capacity) {
+            capacity *= 2;
+            data = ReallocOrExit(data, capacity);
+        }
+    }
+    if (ferror(file)) {
+        perror("Error reading file");
+        exit(1);
+    }
+    fclose(file);
+    map->data = data;
+#endif
+    return true;
 }
 
 /**
- * @brief Selects a random word from the given file based on the number of lines.
- * 
- * This function selects a random line from the file, which is assumed to contain words,
- * one per line. The file is first opened in read mode, and the function reads up to the 
- * randomly selected line. The selected word is then printed to the console.
+ * @brief Releases the memory view of the file.
  * 
- * @param file Pointer to the file containing the words. The file is opened within the function.
- * @param NumOfLines The total number of lines (words) in the file, used to determine the range for random selection.
+ * @param map The view to release.
  */
-void SelectWord(FILE *file, int NumOfLines, char selectedword[MAX_LENGTH]){
-    srand(time(NULL));
-    int randomLine = rand() % NumOfLines;   // Random num from array
-
-    FileOpenError(&file, FILENAME, "r");
-
-    for (int i = 0; i <= randomLine; i++) {
-        if (fgets(selectedword, MAX_LENGTH, file) == NULL) {
-            fclose(file);
-        }
+void MappedFileClose(MappedFile *map) {
+#ifdef HANGMAN_HAVE_MMAP
+    if (map->mapped) {
+        munmap((void *)map->data, map->size);
     }
-    // Remove the newline character at the end of the selected word, if it exists
-    selectedword[strcspn(selectedword, "\n")] = 0;
+#endif
+    if (!map->mapped) {
+        free((void *)map->data);
+    }
+    map->data = NULL;
+    map->size = 0;
+    map->mapped = false;
 }
 
 /**
- * @brief Manages the main logic for the word guessing game.
+ * @brief Outcome of checking a word with `WordCheck`.
+ */
+typedef enum {
+    WORD_VALID,             // The word can be played
+    WORD_TOO_SHORT,         // The word has fewer than two letters
+    WORD_TOO_LONG,          // The word does not fit into a game buffer
+    WORD_NOT_ALPHABETIC     // The word holds a byte that is not an ASCII letter or an inner space
+} WordStatus;
+
+/**
+ * @brief 1 for every byte that cannot be part of a word, 0 for A-Z, a-z and the space.
  * 
- * This function orchestrates the word guessing game by selecting a random word from the file,
- * converting it to a hidden board representation, and then allowing the player to guess letters
- * until they either win or lose. The player's state (number of wrong guesses) is updated with
- * each incorrect guess.
+ * Unlike `isalpha`, the table does not depend on the locale.
+ */
+const uint8_t NonWordBytes[256] = {
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+    1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1
+};
+
+/**
+ * @brief Checks whether a word is valid, without printing anything.
+ * 
+ * A valid word has at least two bytes, all of them ASCII letters or spaces
+ * between letters, so phrases are words too, and is shorter than `MAX_LENGTH`.
+ * The bytes are checked with one table lookup each, ORed together without
+ * branching, so the check costs the same for every word of a length and suits
+ * bulk filtering.
  * 
- * @param file Pointer to the file containing the list of words to guess from.
+ * @param word The word, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @return The status of the word.
  */
-void WordGuessing(FILE *file){
-    int NumOfLines = CountWordsInFile(file);
-    CloseFile(&file);
-    if(NumOfLines <= 0){
-        printf("No words to guess.\n");
-        exit(0);
+WordStatus WordCheck(const char *word, size_t length) {
+    if (length < 2) {
+        return WORD_TOO_SHORT;
     }
-    char WordToGuess[MAX_LENGTH]; char board[MAX_LENGTH]; int state = 0;
-    SelectWord(file, NumOfLines, WordToGuess);
-    ConvertToBoard(WordToGuess, board);
-    while(state < 7 && (strcmp(WordToGuess, board))){
-        if(!ResolveState(WordToGuess, board, state)){
-            state++;
-        }
-        if(!strcmp(WordToGuess, board)){
-            printf("You WON!\n Thw word was %s\n", WordToGuess);
-        }
+    if (length >= MAX_LENGTH) {
+        return WORD_TOO_LONG;
+    }
+    const unsigned char *bytes = (const unsigned char *)word;
+    uint8_t invalid = bytes[0] == ' ' || bytes[length - 1] == ' ';
+    for (size_t i = 0; i < length; i++) {
+        invalid |= NonWordBytes[bytes[i]];
     }
+    return invalid ? WORD_NOT_ALPHABETIC : WORD_VALID;
 }
 
 /**
- * @brief Handles user commands to either play a game or add words to a file.
+ * @brief Checks whether a word is valid, without printing anything.
  * 
- * The function checks the user's input (`line`) to determine whether they want to play the game or 
- * add words to a file. Depending on the input, it opens the file in the appropriate mode and 
- * either starts the game or calls the `WordInsertion` function to add words to the file.
- * If the user inputs an unrecognized command, the function returns `false` to indicate that the 
- * game should not continue.
+ * @param word The word, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @return true if `WordCheck` accepts the word, false otherwise.
+ */
+bool WordIsValid(const char *word, size_t length) {
+    return WordCheck(word, length) == WORD_VALID;
+}
+
+/**
+ * @brief Finds the next word in a word file held in memory.
  * 
- * @param file Pointer to the file where words will be read from or written to. This file must be 
- *        opened in the appropriate mode based on the user's input.
- * @param line Buffer to store the user's input command.
- * @return true if the game should continue, false otherwise.
+ * Carriage returns are ignored. Empty lines, lines of `MAX_LENGTH` bytes or
+ * more and lines that are not valid words according to `WordIsValid` are
+ * skipped instead of being split into several bogus words.
+ * All readers of the word file go through this function, so they agree on
+ * what counts as a word.
+ * 
+ * @param data Contents of the word file.
+ * @param size Size of the contents in bytes.
+ * @param pos Position to continue from, updated past the returned word.
+ * @param word Set to the start of the word, which is not null-terminated.
+ * @param length Set to the length of the word.
+ * @return true if a word was found, false at the end of the data.
  */
-bool GameContinues(FILE **file, char *line){
-    if (strcmp(line, "play\n") == 0) {
-        FileOpenError(file, FILENAME, "r");
-        
-        WordGuessing(*file);
-        CloseFile(file);
-    } 
-    else if (strcmp(line, "add\n") == 0) {
-        WordInsertion(*file, line);
-    } else {
-        printf("Looks like you do not want to do any of that. Bye!\n");
-        return false;
-    }
-    printf("Do you want to continue play or add ?");
+bool NextWord(const char *data, size_t size, size_t *pos, const char **word, size_t *length) {
+    while (*pos < size) {
+        size_t start = *pos;
+        const char *newline = memchr(data + start, '\n', size - start);
+        size_t end = newline ? (size_t)(newline - data) : size;
+        *pos = end + 1;
+        *length = end - start;
+        if (*length > 0 && data[start + *length - 1] == '\r') {
+            (*length)--;
+        }
+        if (WordIsValid(data + start, *length)) {
+            *word = data + start;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Hashes the bytes of a word using 64-bit FNV-1a.
+ * 
+ * @param word The word to hash, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @return The hash of the word.
+ */
+uint64_t HashWord(const char *word, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)word[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Open addressing hash set of the words in a dictionary.
+ * 
+ * Each slot holds the index of a word plus one, so 0 marks an empty slot.
+ * The capacity is always a power of two and the set is kept at most half
+ * full, which keeps linear probe sequences short.
+ */
+typedef struct {
+    uint64_t *slots;    // Word index + 1 per slot, 0 when empty
+    size_t capacity;    // Number of slots, a power of two
+} WordSet;
+
+/**
+ * @brief How hard a word is to guess.
+ */
+typedef enum {
+    DIFFICULTY_EASY,
+    DIFFICULTY_MEDIUM,
+    DIFFICULTY_HARD,
+    DIFFICULTIES,
+    DIFFICULTY_ANY = DIFFICULTIES   // No constraint on the difficulty
+} Difficulty;
+
+const char *const DifficultyNames[DIFFICULTIES] = { "easy", "medium", "hard" };
+
+/**
+ * @brief Frequency of each letter in English text, in thousandths.
+ */
+const uint8_t LetterFrequency[26] = {
+    82, 15, 28, 43, 127, 22, 20, 61, 70, 2, 8, 40, 24,
+    67, 75, 19, 1, 60, 63, 91, 28, 10, 24, 2, 20, 1
+};
+
+#define DIFFICULTY_HARD_BELOW 300
+#define DIFFICULTY_MEDIUM_BELOW 450
+#define WORD_BUCKET_LENGTHS 40
+#define WORD_BUCKETS (WORD_BUCKET_LENGTHS * DIFFICULTIES)
+
+/**
+ * @brief Scores how hard a word is to guess.
+ * 
+ * The score is the share of English text, in thousandths, made up of the
+ * distinct letters of the word. Words of few and rare letters, like "jazz",
+ * leave most guesses missing and are hard, while long words of common letters
+ * are revealed after a few guesses.
+ * 
+ * @param word The word, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @return The difficulty of the word.
+ */
+Difficulty WordDifficulty(const char *word, size_t length) {
+    uint32_t letters = 0;
+    unsigned coverage = 0;
+    for (size_t i = 0; i < length; i++) {
+        int letter = tolower((unsigned char)word[i]) - 'a';
+        if (letter >= 0 && letter < 26 && !(letters & (1u << letter))) {
+            letters |= 1u << letter;
+            coverage += LetterFrequency[letter];
+        }
+    }
+    return coverage < DIFFICULTY_HARD_BELOW ? DIFFICULTY_HARD
+         : coverage < DIFFICULTY_MEDIUM_BELOW ? DIFFICULTY_MEDIUM : DIFFICULTY_EASY;
+}
+
+/**
+ * @brief Returns the bucket that holds the words of a length and a difficulty.
+ * 
+ * Words of `WORD_BUCKET_LENGTHS - 1` bytes or more, mostly phrases, share the
+ * buckets of the longest length.
+ * 
+ * @param length Length of the words.
+ * @param difficulty Difficulty of the words.
+ * @return Index of the bucket.
+ */
+size_t WordBucketOf(size_t length, Difficulty difficulty) {
+    return (length < WORD_BUCKET_LENGTHS ? length : WORD_BUCKET_LENGTHS - 1) * DIFFICULTIES + difficulty;
+}
+
+/**
+ * @brief Indices of the dictionary words of one length and difficulty.
+ */
+typedef struct {
+    uint64_t *words;            // Indices of the words added to the bucket
+    size_t count;               // Number of words in the bucket
+    size_t capacity;            // Entries allocated for words
+    size_t fixed;               // Compacted or compiled words of the bucket, which are not in words
+    const uint64_t *compiled;   // Indices of the fixed words in a compiled file, NULL if they are compacted
+    uint64_t first;             // Index of the first fixed word if they are compacted, they follow each other
+} WordBucket;
+
+/**
+ * @brief Returns the index of a word of a bucket.
+ * 
+ * @param bucket The bucket.
+ * @param i Position of the word in the bucket, lower than its count.
+ * @return Index of the word in the dictionary.
+ */
+uint64_t BucketWord(const WordBucket *bucket, size_t i) {
+    if (i < bucket->fixed) {
+        return bucket->compiled != NULL ? bucket->compiled[i] : bucket->first + i;
+    }
+    return bucket->words[i - bucket->fixed];
+}
+
+/**
+ * @brief Constraints a randomly selected word must satisfy.
+ */
+typedef struct {
+    size_t length;          // Length of the word, 0 for any length
+    Difficulty difficulty;  // Difficulty of the word, DIFFICULTY_ANY for any
+} WordFilter;
+
+/**
+ * @brief Checks whether a word satisfies the constraints of a filter.
+ * 
+ * @param filter The constraints, or NULL for none.
+ * @param word The word, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @return true if the word satisfies the constraints, false otherwise.
+ */
+bool WordMatches(const WordFilter *filter, const char *word, size_t length) {
+    return filter == NULL || ((filter->length == 0 || filter->length == length)
+        && (filter->difficulty == DIFFICULTY_ANY || filter->difficulty == WordDifficulty(word, length)));
+}
+
+/**
+ * @brief Parses the constraints given after the play command.
+ * 
+ * The arguments are separated by spaces and may hold a word length and one
+ * of the difficulties "easy", "medium" and "hard", in any order.
+ * 
+ * @param args The arguments, may end with a newline.
+ * @param filter Filled with the constraints; missing ones match any word.
+ * @return true if all arguments are valid, false otherwise.
+ */
+bool ParseWordFilter(const char *args, WordFilter *filter) {
+    filter->length = 0;
+    filter->difficulty = DIFFICULTY_ANY;
+    for (;;) {
+        args += strspn(args, " \t\r\n");
+        size_t size = strcspn(args, " \t\r\n");
+        if (size == 0) {
+            return true;
+        }
+        bool known = false;
+        for (int difficulty = 0; difficulty < DIFFICULTIES; difficulty++) {
+            if (strlen(DifficultyNames[difficulty]) == size && strncmp(args, DifficultyNames[difficulty], size) == 0) {
+                filter->difficulty = (Difficulty)difficulty;
+                known = true;
+            }
+        }
+        if (!known) {
+            char *end;
+            unsigned long length = strtoul(args, &end, 10);
+            if (end != args + size || length == 0 || length >= MAX_LENGTH || !isdigit((unsigned char)*args)) {
+                return false;
+            }
+            filter->length = length;
+        }
+        args += size;
+    }
+}
+
+#define FRONT_BLOCK_WORDS 16
+
+/**
+ * @brief Sorted words stored in front-coded blocks, a compact alternative to separate strings.
+ * 
+ * Every block holds `FRONT_BLOCK_WORDS` consecutive words of the list, which
+ * is sorted by bucket (see `WordBucketOf`) and bytewise within every bucket,
+ * so the words of a bucket follow each other. Every word is stored as the number of leading bytes it shares with the
+ * word before it in the block, the number of bytes that follow, both as
+ * varints, and those bytes; the first word of a block shares nothing. Sorted
+ * words share long prefixes, so this takes a fraction of the memory of
+ * null-terminated strings with offsets and a hash index, in exchange for
+ * decoding part of a block to read a word.
+ */
+typedef struct {
+    size_t words;       // Words in the blocks, the first ones of the dictionary
+    uint8_t *bytes;     // All blocks one after the other
+    size_t size;        // Bytes used in bytes
+    uint64_t *blocks;   // Offset in bytes of the start of every block
+    uint64_t id;        // Identifies the blocks in the decoded word of every thread, 0 if there are none
+} FrontCoding;
+
+/**
+ * @brief The word of front-coded blocks a thread decoded last.
+ * 
+ * It is kept to continue from when the next word of the same block is read,
+ * so reading the words in order decodes every word only once.
+ */
+typedef struct {
+    uint64_t id;            // Blocks the word was decoded from, see FrontCoding
+    size_t index;           // Index of the word
+    size_t next;            // Offset in the bytes right after the word
+    size_t length;          // Length of the word
+    char word[MAX_LENGTH];  // The null-terminated word
+} FrontCursor;
+
+_Thread_local FrontCursor LocalCursor;
+atomic_uint_fast64_t FrontCodingIds = 1;
+
+/**
+ * @brief Reads a varint of front-coded blocks.
+ * 
+ * @param bytes The blocks.
+ * @param pos Position of the varint, moved past it.
+ * @return The number.
+ */
+size_t FrontReadVarint(const uint8_t *bytes, size_t *pos) {
+    size_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = bytes[(*pos)++];
+        value |= (size_t)(byte & 0x7F) << shift;
+        if (byte < 0x80) {
+            return value;
+        }
+    }
+}
+
+/**
+ * @brief Writes a varint of front-coded blocks.
+ * 
+ * @param bytes The blocks, with room for the varint.
+ * @param pos Position to write at, moved past the varint.
+ * @param value The number.
+ */
+void FrontWriteVarint(uint8_t *bytes, size_t *pos, size_t value) {
+    while (value >= 0x80) {
+        bytes[(*pos)++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    bytes[(*pos)++] = (uint8_t)value;
+}
+
+/**
+ * @brief Decodes a word of front-coded blocks into the decoded word of the thread.
+ * 
+ * @param coding The blocks.
+ * @param index Index of the word, lower than the number of words in the blocks.
+ * @return The decoded word of the thread, valid until the thread decodes another one.
+ */
+const FrontCursor *FrontDecode(const FrontCoding *coding, size_t index) {
+    FrontCursor *cursor = &LocalCursor;
+    if (cursor->id == coding->id && cursor->index == index) {
+        return cursor;
+    }
+    size_t current = index / FRONT_BLOCK_WORDS * FRONT_BLOCK_WORDS, pos = coding->blocks[index / FRONT_BLOCK_WORDS];
+    if (cursor->id == coding->id && cursor->index < index && cursor->index >= current) {
+        current = cursor->index + 1;   // Continue from the word before in the same block
+        pos = cursor->next;
+    }
+    for (; current <= index; current++) {
+        size_t shared = FrontReadVarint(coding->bytes, &pos);
+        size_t suffix = FrontReadVarint(coding->bytes, &pos);
+        memcpy(cursor->word + shared, coding->bytes + pos, suffix);
+        pos += suffix;
+        cursor->length = shared + suffix;
+    }
+    cursor->word[cursor->length] = '\0';
+    cursor->id = coding->id;
+    cursor->index = index;
+    cursor->next = pos;
+    return cursor;
+}
+
+/**
+ * @brief Compares a word with one stored whole in front-coded blocks.
+ * 
+ * @param coding The blocks.
+ * @param pos Position of the stored word, which shares nothing with the one before.
+ * @param word The word, does not need to be null-terminated.
+ * @param length Length of the word.
+ * @return Less than, equal to or greater than 0 as the stored word is below, equal to or above the word.
+ */
+int FrontCompare(const FrontCoding *coding, size_t pos, const char *word, size_t length) {
+    FrontReadVarint(coding->bytes, &pos);
+    size_t stored = FrontReadVarint(coding->bytes, &pos);
+    int order = memcmp(coding->bytes + pos, word, stored < length ? stored : length);
+    return order != 0 ? order : (stored > length) - (stored < length);
+}
+
+/**
+ * @brief Looks up a word among sorted words of front-coded blocks.
+ * 
+ * The block is found by a binary search over the first words of the blocks,
+ * then the block is decoded until the word or a word above it. The decoded
+ * word of the thread is left alone, so the word looked up may be one.
+ * 
+ * @param coding The blocks.
+ * @param first Index of the first of the sorted words.
+ * @param count Number of sorted words, which follow each other.
+ * @param word The word, does not need to be null-terminated.
+ * @param length Length of the word.
+ * @return true if the sorted words hold the word.
+ */
+bool FrontContains(const FrontCoding *coding, size_t first, size_t count, const char *word, size_t length) {
+    if (count == 0) {
+        return false;
+    }
+    // The first block may start with words before the sorted ones, the others start with one of them
+    size_t low = first / FRONT_BLOCK_WORDS + 1, high = (first + count - 1) / FRONT_BLOCK_WORDS + 1;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (FrontCompare(coding, coding->blocks[middle], word, length) <= 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    char current[MAX_LENGTH];
+    size_t block = low - 1, pos = coding->blocks[block];
+    size_t end = (block + 1) * FRONT_BLOCK_WORDS < first + count ? (block + 1) * FRONT_BLOCK_WORDS : first + count;
+    for (size_t i = block * FRONT_BLOCK_WORDS; i < end; i++) {
+        size_t shared = FrontReadVarint(coding->bytes, &pos);
+        size_t suffix = FrontReadVarint(coding->bytes, &pos);
+        memcpy(current + shared, coding->bytes + pos, suffix);
+        pos += suffix;
+        size_t stored = shared + suffix;
+        if (i < first) {
+            continue;
+        }
+        int order = memcmp(current, word, stored < length ? stored : length);
+        order = order != 0 ? order : (stored > length) - (stored < length);
+        if (order >= 0) {
+            return order == 0;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief The words of a compiled dictionary file, read straight from its mapping.
+ * 
+ * The mapping is read-only and backed by the file, so every process that
+ * maps the same compiled file shares one copy of it in memory.
+ */
+typedef struct {
+    size_t words;               // Words in the file, the first ones of the dictionary
+    const char *data;           // Their null-terminated words
+    const uint64_t *offsets;    // words + 1 start offsets into data
+    WordSet index;              // Their hash index, whose slots are in the file
+} CompiledWords;
+
+/**
+ * @brief In-memory word list loaded once from the word file.
+ * 
+ * All words are stored back to back in one contiguous buffer, each terminated
+ * by '\0'. `offsets[i]` is the position where word `i` starts and
+ * `offsets[count]` is the end of the last word, so looking up a word or its
+ * length is O(1) and never touches the file again. Every word is also listed
+ * in the bucket of its length and difficulty, so a random word satisfying a
+ * `WordFilter` is found without looking at the other words.
+ * 
+ * A dictionary loaded from a compiled file holds its words in `compiled`,
+ * and a compacted one, see `DictionaryCompact`, holds them sorted in
+ * `compact`. Either way only words added afterwards are kept in `data`,
+ * `offsets` and the hash index, as if they were a dictionary of their own,
+ * so the first words are never copied.
+ */
+typedef struct {
+    char *data;             // Contiguous storage of all words
+    size_t size;            // Bytes used in data
+    size_t capacity;        // Bytes allocated for data
+    uint64_t *offsets;      // Start offsets into data of its words, and the end of the last one
+    size_t count;           // Number of words in the dictionary
+    size_t offsetCapacity;  // Entries allocated for offsets
+    WordSet index;          // Hash index of the words in data for duplicate checks
+    MappedFile map;         // Compiled file the compiled words point into, if any
+    WordBucket buckets[WORD_BUCKETS];   // Words by length and difficulty, see WordBucketOf
+    CompiledWords compiled; // The first words, straight from a compiled file, if loaded from one
+    FrontCoding compact;    // The first words, sorted and front-coded, if compacted
+} Dictionary;
+
+/**
+ * @brief Initializes an empty dictionary.
+ * 
+ * @param dict Dictionary to initialize.
+ */
+void DictionaryInit(Dictionary *dict) {
+    dict->data = NULL;
+    dict->size = 0;
+    dict->capacity = 0;
+    dict->count = 0;
+    dict->offsetCapacity = 1;
+    dict->offsets = ReallocOrExit(NULL, sizeof(uint64_t));
+    dict->offsets[0] = 0;
+    dict->index.slots = NULL;
+    dict->index.capacity = 0;
+    dict->map.data = NULL;
+    dict->map.size = 0;
+    dict->map.mapped = false;
+    memset(dict->buckets, 0, sizeof(dict->buckets));
+    memset(&dict->compiled, 0, sizeof(dict->compiled));
+    memset(&dict->compact, 0, sizeof(dict->compact));
+}
+
+/**
+ * @brief Releases all memory owned by the dictionary.
+ * 
+ * @param dict Dictionary to free. It is left empty and can be reused after
+ *        calling `DictionaryInit` again.
+ */
+void DictionaryFree(Dictionary *dict) {
+    if (dict->map.data != NULL) {
+        MappedFileClose(&dict->map);    // The compiled words point into the compiled file
+    }
+    free(dict->data);
+    free(dict->offsets);
+    free(dict->index.slots);
+    for (size_t i = 0; i < WORD_BUCKETS; i++) {
+        free(dict->buckets[i].words);
+    }
+    memset(&dict->compiled, 0, sizeof(dict->compiled));
+    free(dict->compact.bytes);
+    free(dict->compact.blocks);
+    memset(&dict->compact, 0, sizeof(dict->compact));
+    memset(dict->buckets, 0, sizeof(dict->buckets));
+    dict->data = NULL;
+    dict->offsets = NULL;
+    dict->index.slots = NULL;
+    dict->index.capacity = 0;
+    dict->size = dict->capacity = 0;
+    dict->count = dict->offsetCapacity = 0;
+}
+
+/**
+ * @brief Returns the index of the first word kept in the buffers of the dictionary.
+ * 
+ * @param dict The dictionary.
+ * @return The number of compiled or compacted words, which come first.
+ */
+size_t DictionaryFirstAdded(const Dictionary *dict) {
+    return dict->compiled.words + dict->compact.words;
+}
+
+/**
+ * @brief Returns the word stored at the given index.
+ * 
+ * @param dict Dictionary to read from.
+ * @param index Index of the word, must be lower than the number of words.
+ * @return Pointer to the null-terminated word inside the dictionary buffer.
+ *         Words of a compacted dictionary are decoded into a buffer of the
+ *         thread instead, which the next compacted word overwrites.
+ */
+const char *DictionaryWord(const Dictionary *dict, size_t index) {
+    if (index < dict->compact.words) {
+        return FrontDecode(&dict->compact, index)->word;
+    }
+    if (index < dict->compiled.words) {
+        return dict->compiled.data + dict->compiled.offsets[index];
+    }
+    return dict->data + dict->offsets[index - DictionaryFirstAdded(dict)];
+}
+
+/**
+ * @brief Returns the length of the word stored at the given index.
+ * 
+ * @param dict Dictionary to read from.
+ * @param index Index of the word, must be lower than the number of words.
+ * @return Length of the word without the terminating '\0'.
+ */
+size_t DictionaryWordLength(const Dictionary *dict, size_t index) {
+    if (index < dict->compact.words) {
+        return FrontDecode(&dict->compact, index)->length;
+    }
+    if (index < dict->compiled.words) {
+        return dict->compiled.offsets[index + 1] - dict->compiled.offsets[index] - 1;
+    }
+    index -= DictionaryFirstAdded(dict);
+    return dict->offsets[index + 1] - dict->offsets[index] - 1;
+}
+
+/**
+ * @brief Appends the word at the given index to a bucket.
+ * 
+ * @param dict Dictionary whose buckets are updated.
+ * @param bucket Index of the bucket, see `WordBucketOf`.
+ * @param index Index of the word to append.
+ */
+void DictionaryBucketPush(Dictionary *dict, size_t bucket, size_t index) {
+    WordBucket *words = &dict->buckets[bucket];
+    if (words->count - words->fixed == words->capacity) {
+        words->capacity = words->capacity ? words->capacity * 2 : 16;
+        words->words = ReallocOrExit(words->words, words->capacity * sizeof(uint64_t));
+    }
+    words->words[words->count++ - words->fixed] = index;
+}
+
+/**
+ * @brief Puts the word at the given index into the bucket of its length and difficulty.
+ * 
+ * @param dict Dictionary whose buckets are updated.
+ * @param index Index of the word to insert.
+ */
+void DictionaryBucketInsert(Dictionary *dict, size_t index) {
+    size_t length = DictionaryWordLength(dict, index);
+    DictionaryBucketPush(dict, WordBucketOf(length, WordDifficulty(DictionaryWord(dict, index), length)), index);
+}
+
+/**
+ * @brief Puts the word at the given index into the hash index, given its hash.
+ * 
+ * The caller must make sure the index has room for one more word.
+ * 
+ * @param dict Dictionary whose index is updated.
+ * @param index Index of the word to insert.
+ * @param hash The hash of the word computed with `HashWord`.
+ */
+void DictionaryIndexInsertHashed(Dictionary *dict, size_t index, uint64_t hash) {
+    size_t mask = dict->index.capacity - 1;
+    size_t slot = hash & mask;
+    while (dict->index.slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    dict->index.slots[slot] = index + 1;
+}
+
+/**
+ * @brief Puts the word at the given index into the hash index.
+ * 
+ * The caller must make sure the index has room for one more word.
+ * 
+ * @param dict Dictionary whose index is updated.
+ * @param index Index of the word to insert.
+ */
+void DictionaryIndexInsert(Dictionary *dict, size_t index) {
+    DictionaryIndexInsertHashed(dict, index, HashWord(DictionaryWord(dict, index), DictionaryWordLength(dict, index)));
+}
+
+/**
+ * @brief Replaces the hash index with an empty one with room for at least the given number of words.
+ * 
+ * @param dict Dictionary whose index is replaced.
+ * @param words Number of words the index must be able to hold.
+ */
+void DictionaryClearIndex(Dictionary *dict, size_t words) {
+    size_t capacity = 16;
+    while (capacity < words * 2) {
+        capacity *= 2;
+    }
+    free(dict->index.slots);
+    dict->index.slots = ReallocOrExit(NULL, capacity * sizeof(uint64_t));
+    memset(dict->index.slots, 0, capacity * sizeof(uint64_t));
+    dict->index.capacity = capacity;
+}
+
+/**
+ * @brief Rebuilds the hash index with room for at least the given number of words.
+ * 
+ * @param dict Dictionary whose index is rebuilt.
+ * @param words Number of words the index must be able to hold.
+ */
+void DictionaryReserveIndex(Dictionary *dict, size_t words) {
+    DictionaryClearIndex(dict, words);
+    for (size_t i = DictionaryFirstAdded(dict); i < dict->count; i++) {
+        DictionaryIndexInsert(dict, i);
+    }
+}
+
+/**
+ * @brief Looks up a word in one hash index of the dictionary.
+ * 
+ * @param dict Dictionary the index belongs to.
+ * @param set The index, holding indices of words of the dictionary.
+ * @param word The word to look for, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @param hash The hash of the word computed with `HashWord`.
+ * @return true if the index holds the word.
+ */
+bool DictionaryIndexContains(const Dictionary *dict, const WordSet *set, const char *word, size_t length, uint64_t hash) {
+    if (set->capacity == 0) {
+        return false;
+    }
+    size_t mask = set->capacity - 1;
+    size_t slot = hash & mask;
+    while (set->slots[slot] != 0) {
+        size_t index = set->slots[slot] - 1;
+        // Compare lengths first, they are known without touching the word
+        if (DictionaryWordLength(dict, index) == length && memcmp(DictionaryWord(dict, index), word, length) == 0) {
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return false;
+}
+
+/**
+ * @brief Looks up a word in the dictionary.
+ * 
+ * Compiled words are looked up in the hash index of the compiled file and
+ * compacted ones in the sorted words of their bucket, the words added
+ * afterwards in the hash index of the dictionary.
+ * 
+ * @param dict Dictionary to search.
+ * @param word The word to look for, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ * @return true if the dictionary contains the word, false otherwise.
+ */
+bool DictionaryContains(const Dictionary *dict, const char *word, size_t length) {
+    if (dict->compact.words > 0) {
+        const WordBucket *bucket = &dict->buckets[WordBucketOf(length, WordDifficulty(word, length))];
+        if (FrontContains(&dict->compact, bucket->first, bucket->fixed, word, length)) {
+            return true;
+        }
+    }
+    if (dict->compiled.index.capacity == 0 && dict->index.capacity == 0) {
+        return false;
+    }
+    uint64_t hash = HashWord(word, length);
+    return DictionaryIndexContains(dict, &dict->compiled.index, word, length, hash)
+        || DictionaryIndexContains(dict, &dict->index, word, length, hash);
+}
+
+/**
+ * @brief Appends a word to the end of the dictionary.
+ * 
+ * The buffers and the hash index grow geometrically, so adding words one
+ * by one stays amortized O(1). The word is copied into the dictionary; the
+ * compiled or compacted words stay where they are.
+ * 
+ * @param dict Dictionary to add the word to.
+ * @param word The word to add, does not need to be null-terminated.
+ * @param length Length of the word in bytes.
+ */
+void DictionaryAdd(Dictionary *dict, const char *word, size_t length) {
+    if (dict->size + length + 1 > dict->capacity) {
+        size_t capacity = dict->capacity ? dict->capacity : 256;
+        while (dict->size + length + 1 > capacity) {
+            capacity *= 2;
+        }
+        dict->data = ReallocOrExit(dict->data, capacity);
+        dict->capacity = capacity;
+    }
+    size_t added = dict->count - DictionaryFirstAdded(dict);   // Words not compiled or compacted
+    if (added + 2 > dict->offsetCapacity) {
+        dict->offsetCapacity *= 2;
+        dict->offsets = ReallocOrExit(dict->offsets, dict->offsetCapacity * sizeof(uint64_t));
+    }
+    memcpy(dict->data + dict->size, word, length);
+    dict->data[dict->size + length] = '\0';
+    dict->size += length + 1;
+    dict->count++;
+    dict->offsets[++added] = dict->size;
+
+    if (added * 2 > dict->index.capacity) {
+        DictionaryReserveIndex(dict, added * 2);
+    } else {
+        DictionaryIndexInsert(dict, dict->count - 1);
+    }
+    DictionaryBucketInsert(dict, dict->count - 1);
+}
+
+/**
+ * @brief A word of a dictionary while it is being compacted.
+ */
+typedef struct {
+    const char *word;   // The null-terminated word
+    size_t length;      // Length of the word
+    size_t bucket;      // Bucket of the word, see WordBucketOf
+} CompactEntry;
+
+/**
+ * @brief Orders words by bucket, then bytewise.
+ */
+int CompactEntryCompare(const void *a, const void *b) {
+    const CompactEntry *x = a, *y = b;
+    if (x->bucket != y->bucket) {
+        return x->bucket < y->bucket ? -1 : 1;
+    }
+    return strcmp(x->word, y->word);
+}
+
+/**
+ * @brief Replaces the words of a dictionary with sorted, front-coded blocks.
+ * 
+ * The words are sorted by bucket and then bytewise and get the indices of
+ * that order, so the words of every bucket follow each other and a bucket
+ * needs no list of indices. Selecting a word by index selects it by rank.
+ * The strings, their offsets, the hash index and the lists of the buckets
+ * are released; lookups search the sorted words of the bucket instead.
+ * Words added later are kept apart as before, so the dictionary can still
+ * grow. A dictionary is compacted only once; compiling it compiles a copy
+ * with the words as they were added.
+ * 
+ * @param dict The loaded dictionary.
+ */
+void DictionaryCompact(Dictionary *dict) {
+    size_t count = dict->count, pos = 0, bytes = 0, blocks = (count + FRONT_BLOCK_WORDS - 1) / FRONT_BLOCK_WORDS;
+    if (count == 0 || dict->compact.id != 0) {
+        return;
+    }
+    CompactEntry *entries = ReallocOrExit(NULL, count * sizeof(CompactEntry));
+    for (size_t i = 0; i < count; i++) {
+        entries[i].word = DictionaryWord(dict, i);
+        entries[i].length = DictionaryWordLength(dict, i);
+        entries[i].bucket = WordBucketOf(entries[i].length, WordDifficulty(entries[i].word, entries[i].length));
+        bytes += entries[i].length;
+    }
+    qsort(entries, count, sizeof(CompactEntry), CompactEntryCompare);
+
+    // Two varints of at most two bytes each for words below MAX_LENGTH
+    FrontCoding coding = { .words = count };
+    coding.bytes = ReallocOrExit(NULL, bytes + count * 4);
+    coding.blocks = ReallocOrExit(NULL, blocks * sizeof(uint64_t));
+    WordBucket buckets[WORD_BUCKETS];
+    memset(buckets, 0, sizeof(buckets));
+    for (size_t i = 0; i < count; i++) {
+        const CompactEntry *entry = &entries[i];
+        size_t shared = 0;
+        if (i % FRONT_BLOCK_WORDS == 0) {
+            coding.blocks[i / FRONT_BLOCK_WORDS] = pos;
+        } else {
+            size_t limit = entry->length < entries[i - 1].length ? entry->length : entries[i - 1].length;
+            while (shared < limit && entry->word[shared] == entries[i - 1].word[shared]) {
+                shared++;
+            }
+        }
+        FrontWriteVarint(coding.bytes, &pos, shared);
+        FrontWriteVarint(coding.bytes, &pos, entry->length - shared);
+        memcpy(coding.bytes + pos, entry->word + shared, entry->length - shared);
+        pos += entry->length - shared;
+        if (buckets[entry->bucket].fixed++ == 0) {
+            buckets[entry->bucket].first = i;
+        }
+    }
+    free(entries);
+    coding.bytes = ReallocOrExit(coding.bytes, pos);
+    coding.size = pos;
+    coding.id = atomic_fetch_add(&FrontCodingIds, 1);
+
+    DictionaryFree(dict);
+    DictionaryInit(dict);
+    dict->compact = coding;
+    dict->count = count;
+    for (size_t i = 0; i < WORD_BUCKETS; i++) {
+        dict->buckets[i] = buckets[i];
+        dict->buckets[i].count = buckets[i].fixed;
+    }
+}
+
+/**
+ * @brief Part of a word file loaded by one thread.
+ * 
+ * Chunks start right after a newline, so no word is split between two chunks.
+ */
+typedef struct {
+    const char *data;   // Contents of the whole word file
+    size_t begin;       // Offset of the first byte of the chunk
+    size_t end;         // Offset past the last byte of the chunk
+    size_t words;       // Number of words in the chunk
+    size_t bytes;       // Bytes the words of the chunk take in the dictionary
+    size_t firstWord;   // Index in the dictionary of the first word of the chunk
+    size_t firstByte;   // Offset in the dictionary of the first word of the chunk
+    Dictionary *dict;   // Dictionary the words are copied into
+    uint64_t *hashes;   // Hash of every word of the dictionary
+    uint8_t *buckets;   // Bucket of every word of the dictionary
+} LoadChunk;
+
+/**
+ * @brief Counts the words of a chunk and the bytes they take.
+ * 
+ * @param arg The `LoadChunk` to count.
+ * @return NULL.
+ */
+void *LoadChunkCount(void *arg) {
+    LoadChunk *chunk = arg;
+    size_t pos = chunk->begin, length; const char *word;
+    while (NextWord(chunk->data, chunk->end, &pos, &word, &length)) {
+        chunk->words++;
+        chunk->bytes += length + 1;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Copies the words of a chunk into the dictionary, hashing and bucketing them.
+ * 
+ * Every chunk writes to its own range of the dictionary buffers, which was
+ * reserved by counting all chunks first, so the chunks need no locking.
+ * 
+ * @param arg The `LoadChunk` to copy.
+ * @return NULL.
+ */
+void *LoadChunkCopy(void *arg) {
+    LoadChunk *chunk = arg;
+    Dictionary *dict = chunk->dict;
+    size_t index = chunk->firstWord, offset = chunk->firstByte, pos = chunk->begin, length;
+    const char *word;
+    while (NextWord(chunk->data, chunk->end, &pos, &word, &length)) {
+        memcpy(dict->data + offset, word, length);
+        dict->data[offset + length] = '\0';
+        offset += length + 1;
+        dict->offsets[index + 1] = offset;
+        chunk->hashes[index] = HashWord(word, length);
+        chunk->buckets[index] = (uint8_t)WordBucketOf(length, WordDifficulty(word, length));
+        index++;
+    }
+    return NULL;
+}
+
+/**
+ * @brief Runs a function on every chunk, each in its own thread.
+ * 
+ * The first chunk is handled by the calling thread. Without threads, or if a
+ * thread cannot be started, chunks are handled by the calling thread one
+ * after the other.
+ * 
+ * @param run The function to run.
+ * @param chunks The chunks.
+ * @param count Number of chunks.
+ */
+void LoadChunksRun(void *(*run)(void *), LoadChunk *chunks, size_t count) {
+#ifdef HANGMAN_HAVE_THREADS
+    pthread_t threads[LOAD_MAX_THREADS];
+    bool started[LOAD_MAX_THREADS] = { false };
+    for (size_t i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, run, &chunks[i]) == 0;
+    }
+    run(&chunks[0]);
+    for (size_t i = 1; i < count; i++) {
+        if (started[i]) {
+            pthread_join(threads[i], NULL);
+        } else {
+            run(&chunks[i]);
+        }
+    }
+#else
+    for (size_t i = 0; i < count; i++) {
+        run(&chunks[i]);
+    }
+#endif
+}
+
+/**
+ * @brief Returns the number of threads to load a file of the given size with.
+ * 
+ * @param size Size of the file in bytes.
+ * @return One thread per `LOAD_CHUNK_MIN` bytes, at most one per core.
+ */
+size_t LoadThreads(size_t size) {
+    size_t threads = 1;
+#ifdef HANGMAN_HAVE_THREADS
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = cores > 1 ? (size_t)cores : 1;
+#endif
+    if (threads > size / LOAD_CHUNK_MIN) {
+        threads = size / LOAD_CHUNK_MIN;
+    }
+    return threads < 1 ? 1 : threads > LOAD_MAX_THREADS ? LOAD_MAX_THREADS : threads;
+}
+
+/**
+ * @brief Loads every word of the given file into the dictionary.
+ * 
+ * The file is mapped into memory with `MappedFileOpen` and split into
+ * newline-aligned chunks, one per core for large files. The chunks are scanned
+ * in parallel twice with `NextWord`: once to count their words, which sizes
+ * the buffers exactly and tells every chunk where its words go, and once to
+ * copy, validate, hash and bucket the words. The precomputed hashes and buckets
+ * are then merged into the hash index and the buckets in word order, which is
+ * the only serial step left. A missing file results in an empty dictionary,
+ * so words can still be added to it.
+ * 
+ * @param dict Initialized, empty dictionary to fill.
+ * @param filename Name of the file with one word per line.
+ */
+void DictionaryLoad(Dictionary *dict, const char *filename) {
+    MappedFile map;
+    uint64_t start = StatStart();
+    if (!MappedFileOpen(&map, filename)) {
+        return;
+    }
+
+    LoadChunk chunks[LOAD_MAX_THREADS];
+    size_t count = LoadThreads(map.size), begin = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t end = map.size * (i + 1) / count;
+        if (end <= begin) {
+            end = begin;    // The previous chunk already took this part of the file
+        } else if (end < map.size) {
+            const char *newline = memchr(map.data + end - 1, '\n', map.size - end + 1);
+            end = newline != NULL ? (size_t)(newline - map.data) + 1 : map.size;
+        }
+        chunks[i] = (LoadChunk){ .data = map.data, .begin = begin, .end = end, .dict = dict };
+        begin = end;
+    }
+    LoadChunksRun(LoadChunkCount, chunks, count);
+
+    size_t words = 0, bytes = 0;
+    for (size_t i = 0; i < count; i++) {
+        words += chunks[i].words;
+        bytes += chunks[i].bytes;
+    }
+    dict->offsets = ReallocOrExit(dict->offsets, (words + 1) * sizeof(uint64_t));
+    dict->offsetCapacity = words + 1;
+    dict->capacity = bytes + 1;
+    dict->data = ReallocOrExit(dict->data, dict->capacity);
+    uint64_t *hashes = ReallocOrExit(NULL, (words + 1) * sizeof(uint64_t));
+    uint8_t *buckets = ReallocOrExit(NULL, words + 1);
+
+    dict->offsets[0] = 0;
+    for (size_t i = 0, firstWord = 0, firstByte = 0; i < count; i++) {
+        chunks[i].firstWord = firstWord;
+        chunks[i].firstByte = firstByte;
+        chunks[i].hashes = hashes;
+        chunks[i].buckets = buckets;
+        firstWord += chunks[i].words;
+        firstByte += chunks[i].bytes;
+    }
+    LoadChunksRun(LoadChunkCopy, chunks, count);
+    MappedFileClose(&map);
+    dict->count = words;
+    dict->size = bytes;
+
+    DictionaryClearIndex(dict, words);
+    for (size_t i = 0; i < words; i++) {
+        DictionaryIndexInsertHashed(dict, i, hashes[i]);
+        DictionaryBucketPush(dict, buckets[i], i);
+    }
+    free(hashes);
+    free(buckets);
+    StatStop(STAT_DICTIONARY_SCAN, start);
+}
+
+/**
+ * @brief Builds the name a file is written under before it is renamed over its final name.
+ * 
+ * The name is different for every process, so processes writing the same
+ * file at once never write into each other's temporary file.
+ * 
+ * @param temporary Buffer to store the name.
+ * @param size Size of the buffer.
+ * @param filename Final name of the file.
+ */
+void TemporaryFilename(char *temporary, size_t size, const char *filename) {
+#ifdef HANGMAN_POSIX
+    snprintf(temporary, size, "%s.%ld.tmp", filename, (long)getpid());
+#else
+    snprintf(temporary, size, "%s.tmp", filename);
+#endif
+}
+
+/**
+ * @brief What tells whether a file was changed, without reading it.
+ * 
+ * Editors that replace a file by renaming a new one over it change its inode,
+ * even when the size and the modification time happen to stay the same.
+ */
+typedef struct {
+    int64_t mtime;          // Modification time in seconds
+    long mtimeNanoseconds;  // Fraction of the modification time, where the platform keeps it
+    uint64_t size;          // Size in bytes
+    uint64_t inode;         // Inode of the file
+} FileSignature;
+
+/**
+ * @brief Reads the signature of a file.
+ * 
+ * @param filename Name of the file.
+ * @param signature Set to the signature, all zero if the file does not exist.
+ */
+void FileSignatureOf(const char *filename, FileSignature *signature) {
+    struct stat info;
+    memset(signature, 0, sizeof(*signature));
+    if (stat(filename, &info) != 0) {
+        return;
+    }
+    signature->mtime = (int64_t)info.st_mtime;
+#if defined(__APPLE__)
+    signature->mtimeNanoseconds = info.st_mtimespec.tv_nsec;
+#elif defined(HANGMAN_POSIX)
+    signature->mtimeNanoseconds = info.st_mtim.tv_nsec;
+#endif
+    signature->size = (uint64_t)info.st_size;
+    signature->inode = (uint64_t)info.st_ino;
+}
+
+/**
+ * @brief Compares two file signatures.
+ * 
+ * @return true if both describe the same contents.
+ */
+bool FileSignatureEqual(const FileSignature *a, const FileSignature *b) {
+    return a->mtime == b->mtime && a->mtimeNanoseconds == b->mtimeNanoseconds
+        && a->size == b->size && a->inode == b->inode;
+}
+
+/**
+ * @brief Header at the start of a compiled dictionary file.
+ * 
+ * The header is followed by the `count + 1` word offsets, the `indexCapacity`
+ * slots of the hash index, the `WORD_BUCKETS` sizes of the buckets, the `count`
+ * word indices of all buckets one after the other and finally the `dataSize`
+ * bytes of null-terminated words, exactly as a `Dictionary` holds them in memory. All numbers are stored
+ * in the byte order of the machine that compiled the file; a file from a machine
+ * with the other byte order fails the version check. The signature of the word
+ * file tells whether the compiled file is still up to date.
+ */
+typedef struct {
+    char magic[8];          // COMPILED_MAGIC
+    uint32_t version;       // COMPILED_VERSION
+    uint32_t reserved;      // Always 0
+    uint64_t count;         // Number of words
+    uint64_t dataSize;      // Bytes of word data
+    uint64_t indexCapacity; // Slots in the hash index, a power of two
+    uint64_t checksum;      // CompiledChecksum of everything after the header
+    FileSignature source;   // Word file as it was when its words were loaded, all zero if unknown
+} CompiledHeader;
+
+#define COMPILED_MAGIC "HANGDICT"
+#define COMPILED_VERSION 4
+
+/**
+ * @brief Computes the checksum stored in the header of a compiled dictionary.
+ * 
+ * The body is read 8 bytes at a time into four independent lanes, so the
+ * checksum keeps up with reading the file and can be verified on every load,
+ * which a byte-by-byte hash like `HashWord` cannot.
+ * 
+ * @param body Everything after the header.
+ * @param size Size of the body in bytes.
+ * @return The checksum of the body.
+ */
+uint64_t CompiledChecksum(const char *body, size_t size) {
+    uint64_t lanes[4] = { 14695981039346656037ULL, 1099511628211ULL, 0x9E3779B97F4A7C15ULL, size };
+    size_t pos = 0;
+    for (; pos + 32 <= size; pos += 32) {
+        for (int i = 0; i < 4; i++) {
+            uint64_t word;
+            memcpy(&word, body + pos + i * 8, sizeof(word));
+            lanes[i] = (lanes[i] ^ word) * 0xFF51AFD7ED558CCDULL;
+            lanes[i] ^= lanes[i] >> 29;
+        }
+    }
+    uint64_t hash = HashWord(body + pos, size - pos);
+    for (int i = 0; i < 4; i++) {
+        hash = (hash ^ lanes[i]) * 0xC4CEB9FE1A85EC53ULL;
+        hash ^= hash >> 32;
+    }
+    return hash;
+}
+
+/**
+ * @brief Writes the dictionary to a compiled dictionary file.
+ * 
+ * The file is written next to its final name with `TemporaryFilename` and
+ * renamed over it once it is complete, so a running game never sees a half
+ * written dictionary, even when several processes compile the same file at once.
+ * 
+ * @param dict The dictionary to write.
+ * @param filename Name of the compiled dictionary file.
+ * @param source Signature of the word file when the dictionary was loaded from it, or NULL.
+ */
+void DictionaryCompile(const Dictionary *dict, const char *filename, const FileSignature *source) {
+    if (DictionaryFirstAdded(dict) > 0) {
+        // Compiled or compacted words are not laid out as the file needs them, so compile a copy
+        Dictionary copy;
+        DictionaryInit(&copy);
+        for (size_t i = 0; i < dict->count; i++) {
+            DictionaryAdd(&copy, DictionaryWord(dict, i), DictionaryWordLength(dict, i));
+        }
+        DictionaryReserveIndex(&copy, copy.count);
+        DictionaryCompile(&copy, filename, source);
+        DictionaryFree(&copy);
+        return;
+    }
+    size_t offsetsSize = (dict->count + 1) * sizeof(uint64_t);
+    size_t indexSize = dict->index.capacity * sizeof(uint64_t);
+    size_t bucketsSize = (WORD_BUCKETS + dict->count) * sizeof(uint64_t);
+    size_t bodySize = offsetsSize + indexSize + bucketsSize + dict->size;
+    char *body = ReallocOrExit(NULL, bodySize);
+    memcpy(body, dict->offsets, offsetsSize);
+    memcpy(body + offsetsSize, dict->index.slots, indexSize);
+    uint64_t *sizes = (uint64_t *)(body + offsetsSize + indexSize), *words = sizes + WORD_BUCKETS;
+    for (size_t i = 0; i < WORD_BUCKETS; i++) {
+        sizes[i] = dict->buckets[i].count;
+        if (sizes[i] > 0) {
+            memcpy(words, dict->buckets[i].words, sizes[i] * sizeof(uint64_t));
+            words += sizes[i];
+        }
+    }
+    memcpy(body + offsetsSize + indexSize + bucketsSize, dict->data, dict->size);
+
+    CompiledHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, COMPILED_MAGIC, sizeof(header.magic));
+    header.version = COMPILED_VERSION;
+    header.count = dict->count;
+    header.dataSize = dict->size;
+    header.indexCapacity = dict->index.capacity;
+    header.checksum = CompiledChecksum(body, bodySize);
+    if (source != NULL) {
+        header.source = *source;
+    }
+
+    char temporary[FILENAME_MAX];
+    TemporaryFilename(temporary, sizeof(temporary), filename);
+    FILE *file;
+    FileOpenError(&file, temporary, "wb");
+    if (fwrite(&header, sizeof(header), 1, file) != 1 || fwrite(body, 1, bodySize, file) != bodySize
+        || fflush(file) != 0) {
+        perror("Error writing file");
+        exit(1);
+    }
+    CloseFile(&file);
+    free(body);
+#ifdef _WIN32
+    remove(filename);   // rename does not replace existing files on Windows
+#endif
+    if (rename(temporary, filename) != 0) {
+        perror("Error renaming file");
+        exit(1);
+    }
+}
+
+/**
+ * @brief Checks that the body of a compiled dictionary can be used as it is.
+ * 
+ * Every word must be non-empty, null-terminated and follow the previous one
+ * within the word data, every slot of the hash index and every entry of the
+ * buckets must name a word, and the checksum must match.
+ * 
+ * @param header The header, whose sizes already match the size of the body.
+ * @param body Everything after the header.
+ * @return true if the body is intact.
+ */
+bool CompiledBodyValid(const CompiledHeader *header, const char *body) {
+    const uint64_t *offsets = (const uint64_t *)body, *slots = offsets + header->count + 1;
+    const uint64_t *words = slots + header->indexCapacity + WORD_BUCKETS;
+    const char *data = (const char *)(words + header->count);
+    if (offsets[0] != 0 || offsets[header->count] != header->dataSize) {
+        return false;
+    }
+    for (uint64_t i = 0; i < header->count; i++) {
+        if (offsets[i + 1] <= offsets[i] + 1 || offsets[i + 1] > header->dataSize || data[offsets[i + 1] - 1] != '\0') {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < header->indexCapacity; i++) {
+        if (slots[i] > header->count) {
+            return false;
+        }
+    }
+    for (uint64_t i = 0; i < header->count; i++) {
+        if (words[i] >= header->count) {
+            return false;
+        }
+    }
+    return CompiledChecksum(body, (size_t)(data - body) + header->dataSize) == header->checksum;
+}
+
+/**
+ * @brief Loads a compiled dictionary file without parsing it.
+ * 
+ * The file is mapped with `MappedFileOpen` and the compiled words of the
+ * dictionary point straight into it, so loading takes the same time no matter
+ * how many words there are, and all processes that load the same file share
+ * the pages of the mapping. Words added later never write to it. Only the
+ * header and the bucket sizes are checked here; the words themselves and the
+ * checksum are verified once by `CompiledFileValid` after compiling.
+ * 
+ * @param dict Initialized, empty dictionary to fill.
+ * @param filename Name of the compiled dictionary file.
+ * @param source Current signature of the word file the file must have been
+ *        compiled from, or NULL to load it anyway.
+ * @return true if the dictionary was loaded, false if the file is missing,
+ *         invalid or out of date.
+ */
+bool DictionaryLoadCompiled(Dictionary *dict, const char *filename, const FileSignature *source) {
+    MappedFile map;
+    if (!MappedFileOpen(&map, filename)) {
+        return false;
+    }
+
+    CompiledHeader header;
+    if (map.size < sizeof(header)) {
+        MappedFileClose(&map);
+        return false;
+    }
+    memcpy(&header, map.data, sizeof(header));
+    uint64_t body = map.size - sizeof(header);
+    if (memcmp(header.magic, COMPILED_MAGIC, sizeof(header.magic)) != 0 || header.version != COMPILED_VERSION
+        || header.count >= body / sizeof(uint64_t) || header.indexCapacity <= header.count
+        || (header.indexCapacity & (header.indexCapacity - 1)) != 0
+        || header.indexCapacity > body / sizeof(uint64_t)
+        || (header.count * 2 + 1 + header.indexCapacity + WORD_BUCKETS) * sizeof(uint64_t) + header.dataSize != body
+        || (source != NULL && !FileSignatureEqual(&header.source, source))) {
+        MappedFileClose(&map);
+        return false;
+    }
+#ifdef HANGMAN_HAVE_MMAP
+    if (map.mapped) {
+        madvise((void *)map.data, map.size, MADV_RANDOM);  // Words are looked up, not scanned
+    }
+#endif
+
+    CompiledWords *compiled = &dict->compiled;
+    compiled->offsets = (const uint64_t *)(map.data + sizeof(header));
+    compiled->index.slots = (uint64_t *)(compiled->offsets + header.count + 1);
+    uint64_t *sizes = compiled->index.slots + header.indexCapacity, *words = sizes + WORD_BUCKETS, total = 0;
+    for (size_t i = 0; i < WORD_BUCKETS && total <= header.count; i++) {
+        total = sizes[i] > header.count ? header.count + 1 : total + sizes[i];  // Never wraps around
+    }
+    if (total != header.count) {
+        MappedFileClose(&map);
+        return false;
+    }
+    for (size_t i = 0; i < WORD_BUCKETS; i++) {
+        dict->buckets[i].compiled = words;
+        dict->buckets[i].fixed = dict->buckets[i].count = sizes[i];
+        words += sizes[i];
+    }
+    compiled->data = (const char *)(sizes + WORD_BUCKETS + header.count);
+    compiled->words = dict->count = header.count;
+    compiled->index.capacity = header.indexCapacity;
+    dict->map = map;
+    return true;
+}
+
+/**
+ * @brief Checks a compiled dictionary file from the header to the last word.
+ * 
+ * Loads the file with `DictionaryLoadCompiled` and then checks its body with
+ * `CompiledBodyValid`, which reads every page of it, so it is meant to be run
+ * once after compiling rather than every time the file is loaded.
+ * 
+ * @param filename Name of the compiled dictionary file.
+ * @return true if the file can be loaded and its words and checksum are intact.
+ */
+bool CompiledFileValid(const char *filename) {
+    Dictionary dict;
+    DictionaryInit(&dict);
+    bool valid = DictionaryLoadCompiled(&dict, filename, NULL)
+        && CompiledBodyValid((const CompiledHeader *)dict.map.data, dict.map.data + sizeof(CompiledHeader));
+    DictionaryFree(&dict);
+    return valid;
+}
+
+/**
+ * @brief Loads the dictionary from the compiled file when it is up to date, or from the word file.
+ * 
+ * The compiled file is used only if it was compiled from the word file exactly
+ * as it is now, so words added to the word file after compiling are never
+ * lost. Otherwise the word file is parsed and, if asked to, compiled again,
+ * so the next process to open it maps the compiled file instead; this one
+ * then maps it as well once `CompiledFileValid` has checked it. Processes
+ * that find the file up to date trust it without reading it through.
+ * 
+ * @param dict Initialized, empty dictionary to fill.
+ * @param filename Name of the word file.
+ * @param compiled Name of the compiled dictionary file.
+ * @param compile Whether to compile the word file when the compiled file is not up to date.
+ */
+void DictionaryOpen(Dictionary *dict, const char *filename, const char *compiled, bool compile) {
+    FileSignature source;
+    FileSignatureOf(filename, &source);
+    if (DictionaryLoadCompiled(dict, compiled, &source)) {
+        return;
+    }
+    DictionaryLoad(dict, filename);
+    if (compile) {
+        Dictionary mapped;
+        DictionaryCompile(dict, compiled, &source);
+        DictionaryInit(&mapped);
+        if (CompiledFileValid(compiled) && DictionaryLoadCompiled(&mapped, compiled, &source)) {
+            DictionaryFree(dict);
+            *dict = mapped;
+        } else {
+            DictionaryFree(&mapped);
+        }
+    }
+}
+
+/**
+ * @brief Flushes a file and waits until its contents are on disk.
+ * 
+ * Errors are handled like in `FileOpenError`: an error message is printed
+ * using perror and the program exits. Without `fsync` the contents are only
+ * handed to the operating system.
+ * 
+ * @param file The file to sync.
+ */
+void FileSync(FILE *file) {
+    if (fflush(file) != 0) {
+        perror("Error writing file");
+        exit(1);
+    }
+#ifdef HANGMAN_POSIX
+    if (fsync(fileno(file)) != 0) {
+        perror("Error syncing file");
+        exit(1);
+    }
+#endif
+}
+
+/**
+ * @brief Returns the size of a file.
+ * 
+ * @param filename Name of the file.
+ * @return Size of the file in bytes, 0 if it does not exist.
+ */
+uint64_t FileSize(const char *filename) {
+    struct stat info;
+    return stat(filename, &info) == 0 ? (uint64_t)info.st_size : 0;
+}
+
+/**
+ * @brief Builds the name of a file that belongs to a word file, e.g. its compiled file.
+ * 
+ * The extension of the word file, if any, is replaced, so "WordstoGuess.txt"
+ * becomes "WordstoGuess.bin" for `COMPILED_EXTENSION`.
+ * 
+ * @param derived Buffer to store the name.
+ * @param size Size of the buffer.
+ * @param filename Name of the word file.
+ * @param extension Extension of the derived file, including the dot.
+ */
+void DerivedFilename(char *derived, size_t size, const char *filename, const char *extension) {
+    const char *base = strrchr(filename, '/');
+    const char *dot = strrchr(base != NULL ? base + 1 : filename, '.');
+    int stem = dot != NULL && dot != (base != NULL ? base + 1 : filename) ? (int)(dot - filename) : (int)strlen(filename);
+    snprintf(derived, size, "%.*s%s", stem, filename, extension);
+}
+
+#define JOURNAL_EXTENSION ".journal"
+#define JOURNAL_MAGIC "HANGJRNL"
+#define JOURNAL_COMPACT_RECORDS 4096
+
+/**
+ * @brief Header at the start of the journal file.
+ * 
+ * `base` is the size the word file had when the journal was started. If the
+ * word file has grown by exactly the words of the journal since then, the
+ * journal was compacted right before a crash and is not compacted again.
+ */
+typedef struct {
+    char magic[8];      // JOURNAL_MAGIC
+    uint64_t base;      // Size of the word file when the journal was started
+} JournalHeader;
+
+/**
+ * @brief Header of every record in the journal, followed by the bytes of the word.
+ */
+typedef struct {
+    uint32_t length;    // Length of the word
+    uint32_t checksum;  // JournalChecksum of the word
+} JournalRecord;
+
+/**
+ * @brief Write-ahead journal of the words added to the word file.
+ * 
+ * Added words are appended to the journal as length-prefixed, checksummed
+ * records and committed in groups with a single `fsync`, so they are durable
+ * without an `fsync` per word. A crash can only leave a torn record at the
+ * end of the journal, which fails its checksum and is dropped, never a
+ * partial line in the word file. From time to time the journal is compacted:
+ * its words are appended to the word file, which is synced, and the journal
+ * starts over. The journal also remembers the signature of the word file, so
+ * changes made to it by anyone else can be told apart from its own.
+ */
+typedef struct {
+    const char *filename;   // Name of the journal file
+    const char *wordFile;   // Name of the word file the journal is compacted into
+    FILE *file;             // The journal, opened for appending
+    char *pending;          // Records not written to the journal yet
+    size_t pendingSize;     // Bytes used in pending
+    size_t pendingCapacity; // Bytes allocated for pending
+    size_t records;         // Records in the journal, including pending ones
+    FileSignature wordSignature;    // Word file as last loaded or compacted into
+} Journal;
+
+/**
+ * @brief Computes the checksum of a journal record.
+ * 
+ * @param word The word of the record.
+ * @param length Length of the word.
+ * @return The checksum, which also covers the length.
+ */
+uint32_t JournalChecksum(const char *word, size_t length) {
+    uint64_t hash = HashWord(word, length) ^ ((uint64_t)length * 0x9E3779B97F4A7C15ULL);
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/**
+ * @brief Finds the next intact record in a journal held in memory.
+ * 
+ * @param data Contents of the journal.
+ * @param size Size of the contents in bytes.
+ * @param pos Position of the next record, moved past the returned record.
+ * @param word Set to the start of the word, which is not null-terminated.
+ * @param length Set to the length of the word.
+ * @return true if an intact record was found, false at the end of the journal
+ *         or at a torn or corrupted record, which ends the journal.
+ */
+bool JournalNext(const char *data, size_t size, size_t *pos, const char **word, size_t *length) {
+    JournalRecord record;
+    if (size - *pos < sizeof(record)) {
+        return false;
+    }
+    memcpy(&record, data + *pos, sizeof(record));
+    if (record.length > size - *pos - sizeof(record)
+        || JournalChecksum(data + *pos + sizeof(record), record.length) != record.checksum
+        || !WordIsValid(data + *pos + sizeof(record), record.length)) {
+        return false;
+    }
+    *word = data + *pos + sizeof(record);
+    *length = record.length;
+    *pos += sizeof(record) + record.length;
+    return true;
+}
+
+/**
+ * @brief Replaces the journal file with the given contents.
+ * 
+ * The new journal is written next to its final name with `TemporaryFilename`,
+ * synced and renamed over it, so a crash leaves either the old or the new
+ * journal. The journal is opened again for appending.
+ * 
+ * @param journal The journal.
+ * @param records Intact records to keep after the header.
+ * @param size Size of the records in bytes.
+ */
+void JournalRewrite(Journal *journal, const char *records, size_t size) {
+    JournalHeader header;
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(header.magic));
+    header.base = FileSize(journal->wordFile);
+
+    char temporary[FILENAME_MAX];
+    TemporaryFilename(temporary, sizeof(temporary), journal->filename);
+    FILE *file;
+    FileOpenError(&file, temporary, "wb");
+    if (fwrite(&header, sizeof(header), 1, file) != 1 || (size > 0 && fwrite(records, 1, size, file) != size)) {
+        perror("Error writing file");
+        exit(1);
+    }
+    FileSync(file);
+    CloseFile(&file);
+    CloseFile(&journal->file);
+#ifdef _WIN32
+    remove(journal->filename);  // rename does not replace existing files on Windows
+#endif
+    if (rename(temporary, journal->filename) != 0) {
+        perror("Error renaming file");
+        exit(1);
+    }
+    FileOpenError(&journal->file, journal->filename, "ab");
+}
+
+/**
+ * @brief Checks whether the words of the journal are already at the end of the word file.
+ * 
+ * @param journal The journal.
+ * @param data Contents of the journal.
+ * @param size Size of the contents in bytes.
+ * @param base Size of the word file when the journal was started.
+ * @return true if the journal was compacted but not started over.
+ */
+bool JournalCompacted(const Journal *journal, const char *data, size_t size, uint64_t base) {
+    MappedFile words;
+    bool compacted = false;
+    if (FileSize(journal->wordFile) == base || !MappedFileOpen(&words, journal->wordFile)) {
+        return false;
+    }
+    if (words.size > base) {
+        size_t at = base, pos = sizeof(JournalHeader), length; const char *word;
+        if (at > 0 && words.data[at - 1] != '\n' && words.data[at] == '\n') {
+            at++;   // Newline added in front of the words by the compaction
+        }
+        compacted = true;
+        while (compacted && JournalNext(data, size, &pos, &word, &length)) {
+            compacted = words.size - at > length && memcmp(words.data + at, word, length) == 0 && words.data[at + length] == '\n';
+            at += length + 1;
+        }
+        compacted = compacted && at == words.size;
+    }
+    MappedFileClose(&words);
+    return compacted;
+}
+
+/**
+ * @brief Opens the journal and adds its words to the dictionary.
+ * 
+ * A torn or corrupted record ends the journal; it and everything after it are
+ * dropped from the file. A missing or unreadable journal, or one that was
+ * already compacted, starts over empty.
+ * 
+ * @param journal The journal to open.
+ * @param filename Name of the journal file.
+ * @param wordFile Name of the word file the journal is compacted into.
+ * @param dict Dictionary the words are added to, or NULL when it is not preloaded.
+ */
+void JournalOpen(Journal *journal, const char *filename, const char *wordFile, Dictionary *dict) {
+    journal->filename = filename;
+    journal->wordFile = wordFile;
+    journal->file = NULL;
+    journal->pending = NULL;
+    journal->pendingSize = journal->pendingCapacity = 0;
+    journal->records = 0;
+    FileSignatureOf(wordFile, &journal->wordSignature);
+
+    MappedFile map;
+    JournalHeader header;
+    if (!MappedFileOpen(&map, filename)) {
+        JournalRewrite(journal, NULL, 0);
+        return;
+    }
+    if (map.size < sizeof(header)) {
+        MappedFileClose(&map);
+        JournalRewrite(journal, NULL, 0);
+        return;
+    }
+    memcpy(&header, map.data, sizeof(header));
+    if (memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0
+        || JournalCompacted(journal, map.data, map.size, header.base)) {
+        MappedFileClose(&map);
+        JournalRewrite(journal, NULL, 0);
+        return;
+    }
+
+    size_t pos = sizeof(header), length; const char *word;
+    while (JournalNext(map.data, map.size, &pos, &word, &length)) {
+        if (dict != NULL && !DictionaryContains(dict, word, length)) {
+            DictionaryAdd(dict, word, length);
+        }
+        journal->records++;
+    }
+    if (pos < map.size) {
+        JournalRewrite(journal, map.data + sizeof(header), pos - sizeof(header));   // Drop the torn tail
+    } else {
+        FileOpenError(&journal->file, filename, "ab");
+    }
+    MappedFileClose(&map);
+}
+
+/**
+ * @brief Queues a word to be written to the journal.
+ * 
+ * The word is not durable before the next `JournalCommit`.
+ * 
+ * @param journal The journal.
+ * @param word The valid word, does not need to be null-terminated.
+ * @param length Length of the word.
+ */
+void JournalAppend(Journal *journal, const char *word, size_t length) {
+    JournalRecord record = { (uint32_t)length, JournalChecksum(word, length) };
+    if (journal->pendingSize + sizeof(record) + length > journal->pendingCapacity) {
+        size_t capacity = journal->pendingCapacity ? journal->pendingCapacity : 4096;
+        while (journal->pendingSize + sizeof(record) + length > capacity) {
+            capacity *= 2;
+        }
+        journal->pending = ReallocOrExit(journal->pending, capacity);
+        journal->pendingCapacity = capacity;
+    }
+    memcpy(journal->pending + journal->pendingSize, &record, sizeof(record));
+    memcpy(journal->pending + journal->pendingSize + sizeof(record), word, length);
+    journal->pendingSize += sizeof(record) + length;
+    journal->records++;
+}
+
+/**
+ * @brief Hands the queued records to the operating system, without syncing them.
+ * 
+ * @param journal The journal.
+ */
+void JournalWrite(Journal *journal) {
+    if (journal->pendingSize > 0
+        && (fwrite(journal->pending, 1, journal->pendingSize, journal->file) != journal->pendingSize
+            || fflush(journal->file) != 0)) {
+        perror("Error writing file");
+        exit(1);
+    }
+    journal->pendingSize = 0;
+}
+
+/**
+ * @brief Makes all queued records durable with one write and one sync.
+ * 
+ * @param journal The journal.
+ */
+void JournalCommit(Journal *journal) {
+    if (journal->pendingSize > 0) {
+        JournalWrite(journal);
+        FileSync(journal->file);
+    }
+}
+
+/**
+ * @brief Appends the words of the journal to the word file and starts the journal over.
+ * 
+ * The word file is synced before the journal is started over, so a word is
+ * always in the journal, the word file or both. If the word file was not
+ * changed by anyone else before, its new signature is remembered, so the
+ * compaction itself is not mistaken for a change.
+ * 
+ * @param journal The journal.
+ */
+void JournalCompact(Journal *journal) {
+    JournalCommit(journal);
+    if (journal->records == 0) {
+        return;
+    }
+    FileSignature before;
+    FileSignatureOf(journal->wordFile, &before);
+    bool known = FileSignatureEqual(&before, &journal->wordSignature);
+    MappedFile map;
+    if (MappedFileOpen(&map, journal->filename)) {
+        bool newline = !FileEndsWithNewline(journal->wordFile);
+        FILE *file;
+        FileOpenError(&file, journal->wordFile, "ab");
+        size_t pos = sizeof(JournalHeader), length; const char *word;
+        if (newline) {
+            fputc('\n', file);
+        }
+        while (JournalNext(map.data, map.size, &pos, &word, &length)) {
+            fwrite(word, 1, length, file);
+            fputc('\n', file);
+        }
+        if (ferror(file)) {
+            perror("Error writing file");
+            exit(1);
+        }
+        FileSync(file);
+        CloseFile(&file);
+        MappedFileClose(&map);
+    }
+    JournalRewrite(journal, NULL, 0);
+    journal->records = 0;
+    if (known) {
+        FileSignatureOf(journal->wordFile, &journal->wordSignature);
+    }
+}
+
+/**
+ * @brief Checks whether the word file was changed by anyone but the journal.
+ * 
+ * @param journal The journal.
+ * @param signature Set to the current signature of the word file.
+ * @return true if the word file changed since it was last loaded or compacted into.
+ */
+bool JournalWordFileChanged(const Journal *journal, FileSignature *signature) {
+    FileSignatureOf(journal->wordFile, signature);
+    return !FileSignatureEqual(signature, &journal->wordSignature);
+}
+
+/**
+ * @brief Commits the queued records and closes the journal.
+ * 
+ * @param journal The journal to close.
+ */
+void JournalClose(Journal *journal) {
+    JournalCommit(journal);
+    CloseFile(&journal->file);
+    free(journal->pending);
+    journal->pending = NULL;
+    journal->pendingSize = journal->pendingCapacity = 0;
+}
+
+/**
+ * @brief All word files the game picks words from, each loaded into its own shard.
+ * 
+ * Every word file, e.g. per language or category, is a separate `Dictionary`
+ * with its own hash index and buckets, so the files are loaded and reloaded
+ * independently. Words are numbered across the shards in order, so a random
+ * index weighs every shard by its size. Added words go to the first shard,
+ * whose word file the journal is compacted into.
+ */
+typedef struct {
+    size_t count;                                   // Number of shards
+    bool loaded;                                    // Whether the shards hold the words of their files
+    bool compact;                                   // Whether the shards are compacted once loaded, see DictionaryCompact
+    bool shared;                                    // Whether word files are compiled when loaded, so processes map them
+    char *filenames[CATALOG_MAX_SHARDS];            // Word file of every shard
+    Dictionary *shards[CATALOG_MAX_SHARDS];         // Words of every word file
+    FileSignature signatures[CATALOG_MAX_SHARDS];   // Word files as last loaded, the journal keeps the first one
+} Catalog;
+
+/**
+ * @brief Initializes a catalog without word files.
+ * 
+ * @param catalog Catalog to initialize.
+ */
+void CatalogInit(Catalog *catalog) {
+    catalog->count = 0;
+    catalog->loaded = false;
+    catalog->compact = false;
+    catalog->shared = false;
+}
+
+/**
+ * @brief Adds a word file to the catalog before it is opened.
+ * 
+ * @param catalog The catalog.
+ * @param filename Name of the word file.
+ * @return true if the file was added, false if the catalog is full.
+ */
+bool CatalogAdd(Catalog *catalog, const char *filename) {
+    if (catalog->count == CATALOG_MAX_SHARDS) {
+        return false;
+    }
+    size_t length = strlen(filename) + 1;
+    catalog->filenames[catalog->count] = memcpy(ReallocOrExit(NULL, length), filename, length);
+    catalog->shards[catalog->count] = NULL;
+    catalog->count++;
+    return true;
+}
+
+/**
+ * @brief Adds the word files listed in a file, one name per line, to the catalog.
+ * 
+ * Empty lines and lines starting with '#' are skipped.
+ * 
+ * @param catalog The catalog.
+ * @param listname Name of the file with the list.
+ * @return true if all files were added, false if the catalog is full.
+ */
+bool CatalogAddList(Catalog *catalog, const char *listname) {
+    FILE *list;
+    char line[FILENAME_MAX]; bool truncated;
+    FileOpenError(&list, listname, "r");
+    bool added = true;
+    while (added && ReadLine(list, line, sizeof(line), &truncated)) {
+        if (line[0] != '\0' && line[0] != '#') {
+            added = CatalogAdd(catalog, line);
+        }
+    }
+    CloseFile(&list);
+    return added;
+}
+
+/**
+ * @brief Loads the word file of a shard into a dictionary.
+ * 
+ * The compiled file next to the word file is mapped when it is up to date.
+ * With `shared` set it is compiled first when it is not, so every process
+ * playing from the same word file maps one copy of its words.
+ * 
+ * @param catalog The catalog.
+ * @param shard Index of the shard.
+ * @param dict Initialized, empty dictionary to fill.
+ */
+void CatalogShardOpen(const Catalog *catalog, size_t shard, Dictionary *dict) {
+    char compiled[FILENAME_MAX];
+    DerivedFilename(compiled, sizeof(compiled), catalog->filenames[shard], COMPILED_EXTENSION);
+    DictionaryOpen(dict, catalog->filenames[shard], compiled, catalog->shared);
+    if (catalog->compact) {
+        DictionaryCompact(dict);
+    }
+}
+
+/**
+ * @brief Creates the shards of the catalog, loading their word files if asked to.
+ * 
+ * Every shard is loaded with `CatalogShardOpen`, from its compiled file when
+ * that is up to date.
+ * 
+ * @param catalog The catalog with at least one word file.
+ * @param load Whether to load the words, or leave the shards empty and read the files when needed.
+ */
+void CatalogOpen(Catalog *catalog, bool load) {
+    catalog->loaded = load;
+    for (size_t i = 0; i < catalog->count; i++) {
+        catalog->shards[i] = ReallocOrExit(NULL, sizeof(Dictionary));
+        DictionaryInit(catalog->shards[i]);
+        FileSignatureOf(catalog->filenames[i], &catalog->signatures[i]);
+        if (load) {
+            CatalogShardOpen(catalog, i, catalog->shards[i]);
+        }
+    }
+}
+
+/**
+ * @brief Frees the shards and the names of the word files.
+ * 
+ * @param catalog The catalog.
+ */
+void CatalogFree(Catalog *catalog) {
+    for (size_t i = 0; i < catalog->count; i++) {
+        if (catalog->shards[i] != NULL) {
+            DictionaryFree(catalog->shards[i]);
+            free(catalog->shards[i]);
+        }
+        free(catalog->filenames[i]);
+    }
+    catalog->count = 0;
+}
+
+/**
+ * @brief Counts the words of all shards.
+ * 
+ * @param catalog The loaded catalog.
+ * @return The total number of words.
+ */
+size_t CatalogCount(const Catalog *catalog) {
+    size_t count = 0;
+    for (size_t i = 0; i < catalog->count; i++) {
+        count += catalog->shards[i]->count;
+    }
+    return count;
+}
+
+/**
+ * @brief Returns the word at the given index across all shards.
+ * 
+ * @param catalog The loaded catalog.
+ * @param index Index of the word, lower than `CatalogCount`.
+ * @param length Set to the length of the word.
+ * @return The null-terminated word inside its shard.
+ */
+const char *CatalogWord(const Catalog *catalog, size_t index, size_t *length) {
+    size_t shard = 0;
+    while (index >= catalog->shards[shard]->count) {
+        index -= catalog->shards[shard++]->count;
+    }
+    *length = DictionaryWordLength(catalog->shards[shard], index);
+    return DictionaryWord(catalog->shards[shard], index);
+}
+
+/**
+ * @brief Checks whether any shard holds a word, using the hash index of every shard.
+ * 
+ * @param catalog The loaded catalog.
+ * @param word The word to look up, does not need to be null-terminated.
+ * @param length Length of the word.
+ * @return true if the word is in one of the shards.
+ */
+bool CatalogContains(const Catalog *catalog, const char *word, size_t length) {
+    for (size_t i = 0; i < catalog->count; i++) {
+        if (DictionaryContains(catalog->shards[i], word, length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Checks whether anyone else changed the word file of a shard since it was loaded.
+ * 
+ * The first shard asks the journal, which knows about its own compactions.
+ * 
+ * @param catalog The catalog.
+ * @param journal The journal added words are committed to.
+ * @param shard Index of the shard.
+ * @param signature Set to the current signature of the word file.
+ * @return true if the word file changed.
+ */
+bool CatalogShardChanged(const Catalog *catalog, const Journal *journal, size_t shard, FileSignature *signature) {
+    if (shard == 0) {
+        return JournalWordFileChanged(journal, signature);
+    }
+    FileSignatureOf(catalog->filenames[shard], signature);
+    return !FileSignatureEqual(signature, &catalog->signatures[shard]);
+}
+
+/**
+ * @brief Returns the signature of the word file of a shard as it was last loaded.
+ * 
+ * @param catalog The catalog.
+ * @param journal The journal added words are committed to.
+ * @param shard Index of the shard.
+ * @return The signature the journal or the catalog keeps for the shard.
+ */
+const FileSignature *CatalogShardSignature(const Catalog *catalog, const Journal *journal, size_t shard) {
+    return shard == 0 ? &journal->wordSignature : &catalog->signatures[shard];
+}
+
+/**
+ * @brief Remembers the signature of a word file that was just loaded into its shard.
+ * 
+ * @param catalog The catalog.
+ * @param journal The journal added words are committed to.
+ * @param shard Index of the shard.
+ * @param signature Signature of the word file before it was loaded.
+ */
+void CatalogShardLoaded(Catalog *catalog, Journal *journal, size_t shard, const FileSignature *signature) {
+    if (shard == 0) {
+        journal->wordSignature = *signature;
+    } else {
+        catalog->signatures[shard] = *signature;
+    }
+}
+
+/**
+ * @brief Loads the word files again that someone else changed since they were loaded.
+ * 
+ * Before the first word file is reloaded the journal is compacted, so the
+ * words added meanwhile are part of it. Every new shard is built completely
+ * before it replaces the old one; games in progress keep their own copy of
+ * the word.
+ * 
+ * @param catalog The loaded catalog.
+ * @param journal The journal added words are committed to.
+ * @return true if any shard was reloaded.
+ */
+bool CatalogReload(Catalog *catalog, Journal *journal) {
+    bool reloaded = false;
+    for (size_t i = 0; i < catalog->count; i++) {
+        FileSignature signature;
+        if (!CatalogShardChanged(catalog, journal, i, &signature)) {
+            continue;
+        }
+        if (i == 0) {
+            JournalCompact(journal);
+            CatalogShardChanged(catalog, journal, i, &signature);
+        }
+        Dictionary fresh;
+        DictionaryInit(&fresh);
+        CatalogShardOpen(catalog, i, &fresh);
+        DictionaryFree(catalog->shards[i]);
+        *catalog->shards[i] = fresh;
+        CatalogShardLoaded(catalog, journal, i, &signature);
+        reloaded = true;
+    }
+    return reloaded;
+}
+
+/**
+ * @brief Handles the case when a file is empty or an error occurs while reading it.
+ * 
+ * If the file is empty, a message indicating the end of the file is reached is printed.
+ * If an error occurs while reading the file, an error message is printed using perror.
+ * 
+ * @param filename Name of the file to be checked for emptiness or read errors.
+ * @param mode Mode in which the file should be opened.
+ * @param line Buffer to store the read line from the file.
+ * @return true if the file is empty, false otherwise.
+ */
+bool FileEmpty(const char *filename, const char *mode, char *line) {
+    FILE *file;
+    FileOpenError(&file, filename, mode);
+
+    if (fgets(line, sizeof(line), file) == NULL) {
+        if (feof(file)) {
+            printf("End of file reached.\n");
+            fclose(file);
+            return true;
+        } else if (ferror(file)) {
+            perror("Error reading file");
+            fclose(file);
+            return true;
+        } else {
+            printf("An unknown error occurred.\n");
+            fclose(file);
+            return true;
+        }
+    }
+
+    fclose(file);
+    return false;
+}
+
+/**
+ * @brief Checks if a given word already exists in the dictionary.
+ * 
+ * Looks the word up in the hash index of every shard of the catalog. When
+ * the catalog is not loaded the word files are scanned instead. If the word
+ * is found, prints a message indicating that the word is already in the file.
+ * 
+ * @param catalog The catalog of word files.
+ * @param word The word to search for in the dictionary.
+ * @return true if the word is found, false otherwise.
+ */
+bool WordAlreadyInFile(const Catalog *catalog, const char *word) {
+    bool found = false;
+
+    if (catalog->loaded) {
+        found = CatalogContains(catalog, word, strlen(word));
+    } else {
+        uint64_t start = StatStart();
+        for (size_t i = 0; !found && i < catalog->count; i++) {
+            MappedFile map;
+            if (MappedFileOpen(&map, catalog->filenames[i])) {
+                size_t pos = 0, length, wordLength = strlen(word); const char *line;
+                while (!found && NextWord(map.data, map.size, &pos, &line, &length)) {
+                    found = length == wordLength && memcmp(line, word, length) == 0;
+                }
+                MappedFileClose(&map);
+            }
+        }
+        StatStop(STAT_DICTIONARY_SCAN, start);
+    }
+
+    if (found) {
+        printf("The word '%s' is already in the file.\n", word);
+    }
+    return found;
+}
+
+/**
+ * @brief Validates if the input is a real word.
+ * 
+ * This function checks if the provided word meets certain criteria to be considered valid. 
+ * A valid word must be non-empty and contain only alphabetic characters. The function
+ * ensures that the word is at least a specified length and does not contain any invalid
+ * characters.
+ * 
+ * @param word The word to be validated. It should be a null-terminated string.
+ * 
+ * @return true if the word is valid, false otherwise.
+ */
+bool IsValidWord(const char *word) {
+    // Check if the word is non-empty and contains only alphabetic characters
+    if (!WordIsValid(word, strlen(word))) {
+        printf("Invalid word %s\n", word);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Adds all words from a file or standard input to the word file in one go.
+ * 
+ * The input is streamed line by line, every line is validated with `WordIsValid`,
+ * which does not print anything for the skipped lines, and checked against the
+ * hash indexes of all shards, also catching duplicates within the input
+ * itself. New words go to the first shard. New words are queued in the journal and committed with a single
+ * write and sync at the end, so the import is durable as a whole no matter how
+ * many words it holds, and a crash never leaves a partial line behind.
+ * 
+ * @param catalog The loaded catalog of word files.
+ * @param journal The journal the new words are committed to.
+ * @param source Name of the file to import, or "-" to read from standard input.
+ */
+void WordBulkInsertion(Catalog *catalog, Journal *journal, const char *source) {
+    FILE *input = stdin;
+    if (strcmp(source, "-") != 0) {
+        FileOpenError(&input, source, "r");
+    }
+
+    char line[MAX_LENGTH]; bool truncated;
+    size_t added = 0, duplicates = 0, invalid = 0;
+
+    while (ReadLine(input, line, sizeof(line), &truncated)) {
+        size_t length = strlen(line);
+        if (truncated || !WordIsValid(line, length)) {
+            invalid++;
+            continue;
+        }
+        if (CatalogContains(catalog, line, length)) {
+            duplicates++;
+            continue;
+        }
+        DictionaryAdd(catalog->shards[0], line, length);
+        JournalAppend(journal, line, length);
+        added++;
+    }
+    if (input != stdin) {
+        CloseFile(&input);
+    }
+
+    JournalCommit(journal);
+    printf("Added %zu words, skipped %zu duplicates and %zu invalid words.\n", added, duplicates, invalid);
+}
+
+/**
+ * @brief Counts the total number of words in the dictionary.
+ * 
+ * The dictionary keeps track of the number of words it holds, so this function
+ * does not need to read through the file anymore.
+ * 
+ * @param dict The dictionary loaded from the word file.
+ * 
+ * @return The total number of words in the dictionary.
+ */
+size_t CountWordsInFile(const Dictionary *dict){
+    return dict->count;
+}
+
+/**
+ * @brief Converts the word to a board with underscores.
+ * 
+ * This function takes a word and replaces each letter in the word with an 
+ * underscore (`_`), creating a new string that can be used as the initial
+ * display for the hangman game.
+ * 
+ * @param WordToGuess The original word to be guessed.
+ * @param board The board where each letter of the word is replaced by `_`.
+ */
+void ConvertToBoard(const char WordToGuess[], char board[]) {
+    for (int i = 0; i < strlen(WordToGuess); i++) {
+        if (isalpha(WordToGuess[i])) { 
+            board[i] = '_';            // Replace with underscore
+        } else {
+            board[i] = WordToGuess[i]; // Preserve non-alphabetic characters
+        }
+    }
+    board[strlen(WordToGuess)] = '\0'; 
+}
+
+/**
+ * @brief Positions of every letter in the word to be guessed.
+ * 
+ * `first[letter]` is the first position of that letter in the word plus one,
+ * and `next[i]` is the next position plus one of the letter at position `i`,
+ * 0 ending both, so a guess only visits the positions that hold the letter.
+ * The chains live next to the word in the storage of a `Game`, sized per
+ * word. Bit `letter` of `remaining` is set while that letter is still hidden,
+ * so the word is guessed exactly when `remaining` is 0. Letters are matched
+ * without regard to case.
+ */
+typedef struct {
+    uint16_t first[26];         // First position + 1 of each letter in the word, 0 if none
+    uint32_t remaining;         // Letters of the word that are still hidden
+} LetterTable;
+
+/**
+ * @brief Precomputes the letter table of the word to be guessed.
+ * 
+ * @param WordToGuess The word to be guessed, shorter than `MAX_LENGTH`.
+ * @param length Length of the word.
+ * @param table The table to fill.
+ * @param next Filled with the chains of positions, one entry per position.
+ */
+void BuildLetterTable(const char WordToGuess[], size_t length, LetterTable *table, uint16_t *next) {
+    memset(table, 0, sizeof(*table));
+    for (size_t i = length; i-- > 0; ) {
+        int ch = tolower((unsigned char)WordToGuess[i]);
+        next[i] = 0;
+        if (ch >= 'a' && ch <= 'z') {
+            next[i] = table->first[ch - 'a'];
+            table->first[ch - 'a'] = (uint16_t)(i + 1);
+            table->remaining |= (uint32_t)1 << (ch - 'a');
+        }
+    }
+}
+
+/**
+ * @brief Number of wrong guesses after which the game is lost.
+ */
+#define MAX_WRONG_GUESSES 6
+
+/**
+ * @brief Outcome of a single guess in a game.
+ */
+typedef enum {
+    GUESS_HIT,      // The letter is in the word
+    GUESS_MISS,     // The letter is not in the word, the hangman grows
+    GUESS_REPEATED, // The letter was guessed before, nothing changes
+    GUESS_INVALID   // Not a letter or the game is already over
+} GuessResult;
+
+/**
+ * @brief Longest word whose game fits into the `Game` record itself.
+ */
+#define GAME_INLINE_LENGTH 39
+
+/**
+ * @brief State of one game of hangman, without any input or output.
+ * 
+ * The game keeps its own copy of the word, so it does not depend on the
+ * dictionary the word was selected from. The chains of the letter table, the
+ * word and the board take 4 bytes per letter and are stored in the record for
+ * words of up to `GAME_INLINE_LENGTH` letters, so most games never allocate;
+ * longer words and phrases get storage of exactly their size, which `GameEnd`
+ * releases. Short games can be copied like any other value.
+ */
+typedef struct {
+    size_t length;              // Length of the word
+    uint16_t *heap;             // Storage of words longer than GAME_INLINE_LENGTH, NULL otherwise
+    LetterTable table;          // Positions of the letters in the word
+    uint32_t guessed;           // Letters guessed so far
+    int state;                  // Number of wrong guesses
+    uint16_t storage[GAME_INLINE_LENGTH * 2 + 1];   // Chains, word and board of short words
+} Game;
+
+/**
+ * @brief Returns the storage of the game: the chains of positions, followed by the word and the board.
+ * 
+ * @param game The game.
+ * @return The chains of positions of the letters.
+ */
+uint16_t *GameStorage(const Game *game) {
+    return game->heap != NULL ? game->heap : (uint16_t *)game->storage;
+}
+
+/**
+ * @brief Returns the word to be guessed.
+ * 
+ * @param game The game.
+ * @return The null-terminated word.
+ */
+const char *GameWord(const Game *game) {
+    return (const char *)(GameStorage(game) + game->length);
+}
+
+/**
+ * @brief Starts a new game with the given word.
+ * 
+ * @param game The game to start, which must not hold a game that was not ended.
+ * @param word The word to be guessed, shorter than `MAX_LENGTH`.
+ */
+void GameStart(Game *game, const char *word) {
+    uint64_t start = StatStart();
+    size_t length = strlen(word);
+    game->length = length;
+    game->heap = length > GAME_INLINE_LENGTH ? ReallocOrExit(NULL, (length * 2 + 1) * sizeof(uint16_t)) : NULL;
+    uint16_t *next = GameStorage(game);
+    char *copy = (char *)(next + length), *board = copy + length + 1;
+    memcpy(copy, word, length + 1);
+    ConvertToBoard(copy, board);
+    BuildLetterTable(copy, length, &game->table, next);
+    game->guessed = 0;
+    game->state = 0;
+    StatStop(STAT_BOARD, start);
+}
+
+/**
+ * @brief Releases the storage of a word longer than `GAME_INLINE_LENGTH`.
+ * 
+ * @param game The game to end. A new game can be started in it afterwards.
+ */
+void GameEnd(Game *game) {
+    free(game->heap);
+    game->heap = NULL;
+    game->length = 0;
+}
+
+/**
+ * @brief Checks whether every letter of the word has been guessed.
+ * 
+ * @param game The game to check.
+ * @return true if the game is won, false otherwise.
+ */
+bool GameIsWon(const Game *game) {
+    return game->table.remaining == 0;
+}
+
+/**
+ * @brief Checks whether the hangman is complete.
+ * 
+ * @param game The game to check.
+ * @return true if the game is lost, false otherwise.
+ */
+bool GameIsLost(const Game *game) {
+    return game->state >= MAX_WRONG_GUESSES;
+}
+
+/**
+ * @brief Returns the board with the letters guessed so far.
+ * 
+ * @param game The game to show.
+ * @return The word with hidden letters replaced by `_`.
+ */
+const char *GameBoard(const Game *game) {
+    return GameWord(game) + game->length + 1;
+}
+
+/**
+ * @brief Applies a guessed letter to the game.
+ * 
+ * The chain of the letter is followed from the letter table, so only the
+ * positions that hold the letter are touched on the board. Wrong guesses increase the state
+ * of the game, guessing the same letter again has no effect.
+ * 
+ * @param game The game to guess in.
+ * @param letter The guessed letter.
+ * @return The outcome of the guess.
+ */
+GuessResult GameGuess(Game *game, char letter) {
+    int ch = tolower((unsigned char)letter);
+    if (ch < 'a' || ch > 'z' || GameIsWon(game) || GameIsLost(game)) {
+        return GUESS_INVALID;
+    }
+    int index = ch - 'a';
+    uint32_t bit = (uint32_t)1 << index;
+    if (game->guessed & bit) {
+        return GUESS_REPEATED;
+    }
+    game->guessed |= bit;
+
+    // Reveal every position of the letter in the word
+    uint16_t *next = GameStorage(game);
+    const char *word = GameWord(game);
+    char *board = (char *)GameBoard(game);
+    for (size_t position = game->table.first[index]; position != 0; position = next[position - 1]) {
+        board[position - 1] = word[position - 1];
+    }
+    game->table.remaining &= ~bit;
+    if (game->table.first[index] == 0) {
+        game->state++;
+        return GUESS_MISS;
+    }
+    return GUESS_HIT;
+}
+
+/**
+ * @brief Guesses the whole word at once.
+ * 
+ * A correct guess reveals the whole board and wins the game, a wrong one
+ * counts as one wrong guess. Letters are compared without regard to case.
+ * 
+ * @param game The game to guess in.
+ * @param word The guessed word, does not need to be null-terminated.
+ * @param length Length of the guessed word.
+ * @return GUESS_HIT if the word is right, GUESS_MISS if it is wrong, or
+ *         GUESS_INVALID if the game is already over.
+ */
+GuessResult GameGuessWord(Game *game, const char *word, size_t length) {
+    if (GameIsWon(game) || GameIsLost(game)) {
+        return GUESS_INVALID;
+    }
+    const char *answer = GameWord(game);
+    bool right = length == game->length;
+    for (size_t i = 0; right && i < length; i++) {
+        right = tolower((unsigned char)word[i]) == tolower((unsigned char)answer[i]);
+    }
+    if (!right) {
+        game->state++;
+        return GUESS_MISS;
+    }
+    memcpy((char *)GameBoard(game), answer, game->length + 1);
+    game->table.remaining = 0;
+    return GUESS_HIT;
+}
+
+/**
+ * @brief What a line typed by the player during a game contains.
+ */
+typedef enum {
+    INPUT_LETTER,   // A single letter
+    INPUT_WORD,     // A guess of the whole word
+    INPUT_HINT,     // "?", asking for a hint instead of guessing
+    INPUT_INVALID   // Anything else
+} InputKind;
+
+/**
+ * @brief A guess parsed from a line of input.
+ */
+typedef struct {
+    InputKind kind;     // What the line contains
+    char letter;        // The letter, for INPUT_LETTER
+    const char *word;   // Start of the word inside the line, for INPUT_WORD
+    size_t length;      // Length of the word, for INPUT_WORD
+} ParsedGuess;
+
+/**
+ * @brief Parses one line of input into a guess.
+ * 
+ * Surrounding spaces are ignored. A single letter is a letter guess, two or
+ * more letters, possibly with spaces between them for phrases, are a guess of
+ * the whole word, a single "?" asks for a hint, everything else is invalid.
+ * The line is only looked at, never read from a file, so the same parser
+ * serves the console and the server.
+ * 
+ * @param line The line without the newline.
+ * @param guess Filled with the parsed guess.
+ * @return The kind of the guess.
+ */
+InputKind ParseGuess(const char *line, ParsedGuess *guess) {
+    while (*line == ' ' || *line == '\t') {
+        line++;
+    }
+    size_t length = strlen(line);
+    while (length > 0 && (line[length - 1] == ' ' || line[length - 1] == '\t' || line[length - 1] == '\r')) {
+        length--;
+    }
+    guess->kind = length > 0 ? INPUT_LETTER : INPUT_INVALID;
+    for (size_t i = 0; i < length; i++) {
+        int ch = tolower((unsigned char)line[i]);
+        if ((ch < 'a' || ch > 'z') && ch != ' ') {
+            guess->kind = INPUT_INVALID;
+        }
+    }
+    if (guess->kind != INPUT_INVALID && length > 1) {
+        guess->kind = INPUT_WORD;
+    }
+    if (length == 1 && line[0] == '?') {
+        guess->kind = INPUT_HINT;
+    }
+    guess->letter = line[0];
+    guess->word = line;
+    guess->length = length;
+    return guess->kind;
+}
+
+/**
+ * @brief Applies a parsed guess to the game.
+ * 
+ * @param game The game to guess in.
+ * @param guess The parsed guess.
+ * @return The outcome of the guess.
+ */
+GuessResult GameApplyGuess(Game *game, const ParsedGuess *guess) {
+    uint64_t start = StatStart();
+    GuessResult result = GUESS_INVALID;
+    if (guess->kind == INPUT_LETTER) {
+        result = GameGuess(game, guess->letter);
+    } else if (guess->kind == INPUT_WORD) {
+        result = GameGuessWord(game, guess->word, guess->length);
+    }
+    StatStop(STAT_GUESS, start);
+    return result;
+}
+
+/**
+ * @brief Words of one length, laid out for the solver to filter them quickly.
+ * 
+ * Every word is a row of `stride` bytes holding its lowercase letters padded
+ * with zeros to a multiple of 8, so rows are compared 8 bytes at a time. The
+ * letters every word contains are also kept as a bit set, which rules out
+ * most words after a wrong guess without looking at their rows.
+ */
+typedef struct {
+    size_t count;               // Words of this length
+    size_t stride;              // Bytes per row
+    size_t phrases;             // Words with spaces, which only fit boards with the same spaces
+    uint64_t *rows;             // count rows of stride bytes
+    uint32_t *letters;          // Bit set of the letters of every word
+    uint32_t frequencies[26];   // Words containing every letter
+    struct SolverPattern *patterns; // Rows by the positions of every letter, NULL unless built
+} SolverGroup;
+
+/**
+ * @brief The rows of a group ordered by the positions of one letter in them.
+ * 
+ * The rows with the same positions, which are exactly the ones that fit a
+ * fresh board once the letter has been guessed, follow each other, so the
+ * first guess of a game looks them up instead of filtering the whole group.
+ */
+typedef struct SolverPattern {
+    size_t count;           // Distinct positions of the letter
+    uint64_t *positions;    // Every distinct bit set of positions of the letter, sorted
+    uint32_t *starts;       // First entry in rows of every set of positions, count + 1 entries
+    uint32_t *rows;         // Rows of the group, ordered by the positions of the letter
+    uint32_t (*frequencies)[26];    // Rows of every set of positions containing every letter
+} SolverPattern;
+
+/**
+ * @brief Longest words the patterns of `SolverIndexBuildPatterns` are built for.
+ */
+#define SOLVER_PATTERN_LENGTH 64
+
+/**
+ * @brief Index of the solver: all words grouped by their exact length.
+ * 
+ * The frequencies of the letters of every length are computed while
+ * building it, so the first hint of a game needs no filtering at all.
+ */
+typedef struct {
+    size_t lengths;         // Number of groups, one more than the longest word
+    SolverGroup *groups;    // Group of every length, see SolverGroup
+} SolverIndex;
+
+/**
+ * @brief A computer player that follows one game at a time.
+ * 
+ * The candidates are the rows of the group of the word's length that still
+ * fit the board. They start out as the whole group and are filtered by every
+ * newly guessed letter only, and the frequencies of their letters are kept
+ * up to date along the way, so a hint costs a pass over the candidates that
+ * are left instead of over the whole dictionary.
+ */
+typedef struct {
+    const SolverIndex *index;   // Words the solver knows
+    const SolverGroup *group;   // Words of the length of the current word, NULL if there are none
+    bool all;                   // Every row of group is a candidate and candidates is not filled
+    uint32_t *candidates;       // Rows of group that still fit the board
+    uint32_t *dropped;          // Rows dropped by the last filter
+    size_t count;               // Number of candidates
+    size_t capacity;            // Entries allocated for candidates and dropped
+    uint32_t frequencies[26];   // Candidates containing every letter
+    uint32_t filtered;          // Letters the candidates were filtered by
+    bool proposed;              // The last guess was the only candidate, as a whole word
+} Solver;
+
+/**
+ * @brief Initializes an empty solver index.
+ * 
+ * @param index Index to initialize.
+ */
+void SolverIndexInit(SolverIndex *index) {
+    index->lengths = 0;
+    index->groups = NULL;
+}
+
+/**
+ * @brief Adds the letters of a word to letter frequencies.
+ * 
+ * @param frequencies Frequencies of all 26 letters.
+ * @param letters Bit set of the letters of the word.
+ */
+void CountLetters(uint32_t frequencies[26], uint32_t letters) {
+    while (letters != 0) {
+        int letter = HighestBit(letters);
+        frequencies[letter]++;
+        letters ^= (uint32_t)1 << letter;
+    }
+}
+
+/**
+ * @brief Takes the letters of a word away from letter frequencies.
+ * 
+ * @param frequencies Frequencies of all 26 letters.
+ * @param letters Bit set of the letters of the word.
+ */
+void UncountLetters(uint32_t frequencies[26], uint32_t letters) {
+    while (letters != 0) {
+        int letter = HighestBit(letters);
+        frequencies[letter]--;
+        letters ^= (uint32_t)1 << letter;
+    }
+}
+
+/**
+ * @brief Builds the solver index from the words of dictionaries.
+ * 
+ * @param index Initialized, empty index to fill.
+ * @param shards The dictionaries, e.g. the shards of a catalog.
+ * @param count Number of dictionaries.
+ */
+void SolverIndexBuild(SolverIndex *index, Dictionary *const *shards, size_t count) {
+    size_t longest = 0;
+    for (size_t i = 0; i < count; i++) {
+        for (size_t word = 0; word < shards[i]->count; word++) {
+            size_t length = DictionaryWordLength(shards[i], word);
+            longest = length > longest ? length : longest;
+        }
+    }
+    index->lengths = longest + 1;
+    index->groups = ReallocOrExit(NULL, index->lengths * sizeof(SolverGroup));
+    memset(index->groups, 0, index->lengths * sizeof(SolverGroup));
+    for (size_t i = 0; i < count; i++) {
+        for (size_t word = 0; word < shards[i]->count; word++) {
+            index->groups[DictionaryWordLength(shards[i], word)].count++;
+        }
+    }
+    for (size_t length = 0; length < index->lengths; length++) {
+        SolverGroup *group = &index->groups[length];
+        group->stride = (length + 7) / 8 * 8;
+        if (group->count > 0) {
+            group->rows = ReallocOrExit(NULL, group->count * group->stride);
+            group->letters = ReallocOrExit(NULL, group->count * sizeof(uint32_t));
+            memset(group->rows, 0, group->count * group->stride);
+        }
+        group->count = 0;   // Counted up again while filling in the rows
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        for (size_t word = 0; word < shards[i]->count; word++) {
+            const char *letters = DictionaryWord(shards[i], word);
+            size_t length = DictionaryWordLength(shards[i], word);
+            SolverGroup *group = &index->groups[length];
+            char *row = (char *)group->rows + group->count * group->stride;
+            uint32_t set = 0;
+            for (size_t j = 0; j < length; j++) {
+                row[j] = (char)(letters[j] | 0x20);    // Lowercase, spaces stay spaces
+                if (row[j] == ' ') {
+                    set |= (uint32_t)1 << 31;
+                } else {
+                    set |= (uint32_t)1 << (row[j] - 'a');
+                }
+            }
+            group->phrases += set >> 31;
+            group->letters[group->count++] = set & ~((uint32_t)1 << 31);
+            CountLetters(group->frequencies, set & ~((uint32_t)1 << 31));
+        }
+    }
+}
+
+/**
+ * @brief Releases the memory of the solver index.
+ * 
+ * @param index Index to free. It is left empty.
+ */
+void SolverIndexFree(SolverIndex *index) {
+    for (size_t length = 0; length < index->lengths; length++) {
+        SolverPattern *patterns = index->groups[length].patterns;
+        for (int letter = 0; patterns != NULL && letter < 26; letter++) {
+            free(patterns[letter].positions);
+            free(patterns[letter].starts);
+            free(patterns[letter].rows);
+            free(patterns[letter].frequencies);
+        }
+        free(patterns);
+        free(index->groups[length].rows);
+        free(index->groups[length].letters);
+    }
+    free(index->groups);
+    SolverIndexInit(index);
+}
+
+/**
+ * @brief Initializes a solver that knows the words of an index.
+ * 
+ * @param solver Solver to initialize.
+ * @param index The index, which must outlive the solver.
+ */
+void SolverInit(Solver *solver, const SolverIndex *index) {
+    solver->index = index;
+    solver->group = NULL;
+    solver->candidates = solver->dropped = NULL;
+    solver->count = solver->capacity = 0;
+}
+
+/**
+ * @brief Releases the memory of the solver.
+ * 
+ * @param solver Solver to free.
+ */
+void SolverFree(Solver *solver) {
+    free(solver->candidates);
+    free(solver->dropped);
+    SolverInit(solver, solver->index);
+}
+
+/**
+ * @brief Marks the bytes of a chunk of a row that equal a given byte.
+ * 
+ * The bytes are compared all at once within the 64-bit chunk, without any
+ * carry from one byte into the next.
+ * 
+ * @param chunk 8 bytes of a row.
+ * @param byte The byte to look for, not 0.
+ * @return 0x80 in every byte of the chunk that equals `byte`, 0 in all others.
+ */
+uint64_t ChunkMatches(uint64_t chunk, uint8_t byte) {
+    uint64_t x = chunk ^ (0x0101010101010101ULL * byte);
+    return ~(((x & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL) | x) & 0x8080808080808080ULL;
+}
+
+/**
+ * @brief Packs the marks of `ChunkMatches` into one bit per byte.
+ * 
+ * @param matches 0x80 or 0 in every byte.
+ * @return 8 bits, one for every byte of the chunk.
+ */
+uint64_t ChunkBits(uint64_t matches) {
+    return ((matches >> 7) * 0x0102040810204080ULL) >> 56;
+}
+
+/**
+ * @brief Entry of a row while the patterns of a letter are sorted.
+ */
+typedef struct {
+    uint64_t positions;     // Positions of the letter in the row
+    uint32_t row;           // The row
+} SolverPatternEntry;
+
+/**
+ * @brief Orders pattern entries by positions, then by row.
+ */
+int SolverPatternCompare(const void *a, const void *b) {
+    const SolverPatternEntry *x = a, *y = b;
+    if (x->positions != y->positions) {
+        return x->positions < y->positions ? -1 : 1;
+    }
+    return x->row < y->row ? -1 : x->row > y->row;
+}
+
+/**
+ * @brief Orders the rows of every group by the positions of every letter.
+ * 
+ * This takes 26 sorts of every group and 4 bytes per word and letter, plus
+ * the letter frequencies of every set of positions, which
+ * pays off when many games are played with the same index, e.g. in a
+ * simulation, but not for the occasional hint. Groups of words longer than
+ * `SOLVER_PATTERN_LENGTH` are filtered as before.
+ * 
+ * @param index The built index.
+ */
+void SolverIndexBuildPatterns(SolverIndex *index) {
+    for (size_t length = 1; length < index->lengths && length <= SOLVER_PATTERN_LENGTH; length++) {
+        SolverGroup *group = &index->groups[length];
+        size_t chunks = group->stride / 8;
+        if (group->count == 0 || group->patterns != NULL) {
+            continue;
+        }
+        SolverPatternEntry *entries = ReallocOrExit(NULL, group->count * sizeof(SolverPatternEntry));
+        group->patterns = ReallocOrExit(NULL, 26 * sizeof(SolverPattern));
+        for (int letter = 0; letter < 26; letter++) {
+            SolverPattern *pattern = &group->patterns[letter];
+            for (size_t row = 0; row < group->count; row++) {
+                uint64_t positions = 0;
+                for (size_t chunk = 0; chunk < chunks; chunk++) {
+                    positions |= ChunkBits(ChunkMatches(group->rows[row * chunks + chunk], (uint8_t)('a' + letter))) << (8 * chunk);
+                }
+                entries[row].positions = positions;
+                entries[row].row = (uint32_t)row;
+            }
+            qsort(entries, group->count, sizeof(SolverPatternEntry), SolverPatternCompare);
+            pattern->count = 0;
+            for (size_t i = 0; i < group->count; i++) {
+                pattern->count += i == 0 || entries[i].positions != entries[i - 1].positions;
+            }
+            pattern->positions = ReallocOrExit(NULL, pattern->count * sizeof(uint64_t));
+            pattern->starts = ReallocOrExit(NULL, (pattern->count + 1) * sizeof(uint32_t));
+            pattern->rows = ReallocOrExit(NULL, group->count * sizeof(uint32_t));
+            pattern->frequencies = ReallocOrExit(NULL, pattern->count * sizeof(uint32_t[26]));
+            memset(pattern->frequencies, 0, pattern->count * sizeof(uint32_t[26]));
+            for (size_t i = 0, distinct = 0; i < group->count; i++) {
+                if (i == 0 || entries[i].positions != entries[i - 1].positions) {
+                    pattern->positions[distinct] = entries[i].positions;
+                    pattern->starts[distinct++] = (uint32_t)i;
+                }
+                pattern->rows[i] = entries[i].row;
+                CountLetters(pattern->frequencies[distinct - 1], group->letters[entries[i].row]);
+            }
+            pattern->starts[pattern->count] = (uint32_t)group->count;
+        }
+        free(entries);
+    }
+}
+
+/**
+ * @brief Keeps the rows of a whole group that fit the board, by looking up their pattern.
+ * 
+ * @param solver The solver, whose candidates are still the whole group.
+ * @param pattern The pattern of the guessed letter.
+ * @param expected The marks of the letter on the board, as `ChunkMatches` returns them.
+ * @param chunks Number of chunks of a row.
+ */
+void SolverFilterPattern(Solver *solver, const SolverPattern *pattern, const uint64_t *expected, size_t chunks) {
+    uint64_t positions = 0;
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        positions |= ChunkBits(expected[chunk]) << (8 * chunk);
+    }
+    size_t low = 0, high = pattern->count;
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (pattern->positions[middle] < positions) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    solver->all = false;
+    solver->count = 0;
+    memset(solver->frequencies, 0, sizeof(solver->frequencies));
+    if (low < pattern->count && pattern->positions[low] == positions) {
+        solver->count = pattern->starts[low + 1] - pattern->starts[low];
+        memcpy(solver->candidates, pattern->rows + pattern->starts[low], solver->count * sizeof(uint32_t));
+        memcpy(solver->frequencies, pattern->frequencies[low], sizeof(solver->frequencies));
+    }
+}
+
+/**
+ * @brief Keeps only the candidates that hold a byte exactly where the board shows it.
+ * 
+ * A letter that is not on the board rules out every candidate containing it,
+ * which the bit sets of the letters tell without reading the rows. Otherwise
+ * every row is compared with the positions of the byte on the board, 8 bytes
+ * at a time. The frequencies are updated from whichever is smaller: the
+ * candidates that were dropped or the ones that are left. The first letter
+ * of a game is looked up in the patterns of the group instead, if built.
+ * 
+ * @param solver The solver, following a game.
+ * @param board The board of the game.
+ * @param byte A lowercase letter or a space.
+ * @param bit Bit of the letter in the bit sets, 0 for a space.
+ */
+void SolverFilter(Solver *solver, const char *board, uint8_t byte, uint32_t bit) {
+    const SolverGroup *group = solver->group;
+    size_t chunks = group->stride / 8, total = solver->all ? group->count : solver->count;
+    uint64_t expected[MAX_LENGTH / 8 + 1] = { 0 };
+    bool shown = false;
+    for (size_t i = 0; board[i] != '\0'; i++) {
+        if ((uint8_t)(board[i] | 0x20) == byte && board[i] != '_') {
+            ((uint8_t *)expected)[i] = 0x80;
+            shown = true;
+        }
+    }
+    if (solver->all) {
+        if (solver->capacity < group->count) {
+            solver->candidates = ReallocOrExit(solver->candidates, group->count * sizeof(uint32_t));
+            solver->dropped = ReallocOrExit(solver->dropped, group->count * sizeof(uint32_t));
+            solver->capacity = group->count;
+        }
+    }
+    if (solver->all && bit != 0 && group->patterns != NULL) {
+        SolverFilterPattern(solver, &group->patterns[byte - 'a'], expected, chunks);
+        return;
+    }
+
+    size_t kept = 0, dropped = 0;
+    for (size_t i = 0; i < total; i++) {
+        uint32_t word = solver->all ? (uint32_t)i : solver->candidates[i];
+        bool fits = bit == 0 || ((group->letters[word] & bit) != 0) == shown;
+        if (fits && (shown || bit == 0)) {
+            const uint64_t *row = group->rows + (size_t)word * chunks;
+            for (size_t chunk = 0; fits && chunk < chunks; chunk++) {
+                fits = ChunkMatches(row[chunk], byte) == expected[chunk];
+            }
+        }
+        if (fits) {
+            solver->candidates[kept++] = word;
+        } else {
+            solver->dropped[dropped++] = word;
+        }
+    }
+    solver->all = false;
+    solver->count = kept;
+
+    if (kept < dropped) {
+        memset(solver->frequencies, 0, sizeof(solver->frequencies));
+        for (size_t i = 0; i < kept; i++) {
+            CountLetters(solver->frequencies, group->letters[solver->candidates[i]]);
+        }
+    } else {
+        for (size_t i = 0; i < dropped; i++) {
+            UncountLetters(solver->frequencies, group->letters[solver->dropped[i]]);
+        }
+    }
+}
+
+/**
+ * @brief Starts following a new game.
+ * 
+ * @param solver The solver.
+ * @param game The game, just started.
+ */
+void SolverStart(Solver *solver, const Game *game) {
+    const SolverIndex *index = solver->index;
+    solver->group = game->length < index->lengths && index->groups[game->length].count > 0
+                  ? &index->groups[game->length] : NULL;
+    solver->all = true;
+    solver->count = solver->group != NULL ? solver->group->count : 0;
+    if (solver->group != NULL) {
+        memcpy(solver->frequencies, solver->group->frequencies, sizeof(solver->frequencies));
+    }
+    solver->filtered = 0;
+    solver->proposed = false;
+    if (solver->group != NULL && solver->group->phrases > 0) {
+        SolverFilter(solver, GameBoard(game), ' ', 0);    // Only phrases with the same spaces fit
+    }
+}
+
+/**
+ * @brief Filters the candidates by the letters guessed since the last call.
+ * 
+ * @param solver The solver, following the game.
+ * @param game The game.
+ */
+void SolverSync(Solver *solver, const Game *game) {
+    uint32_t pending = game->guessed & ~solver->filtered;
+    if (solver->proposed && !GameIsWon(game)) {
+        solver->count = 0;  // The only candidate was wrong, the word is not in the index
+        solver->all = false;
+    }
+    solver->proposed = false;
+    for (int letter = 0; letter < 26 && solver->group != NULL && solver->count > 0; letter++) {
+        if (pending & ((uint32_t)1 << letter)) {
+            SolverFilter(solver, GameBoard(game), (uint8_t)('a' + letter), (uint32_t)1 << letter);
+        }
+    }
+    solver->filtered |= pending;
+}
+
+/**
+ * @brief Counts the words that still fit the board.
+ * 
+ * @param solver The solver, synced with its game.
+ * @return The number of candidates.
+ */
+size_t SolverCandidates(const Solver *solver) {
+    return solver->group == NULL ? 0 : solver->all ? solver->group->count : solver->count;
+}
+
+/**
+ * @brief Returns one of the words that still fit the board.
+ * 
+ * @param solver The solver, synced with its game.
+ * @param candidate Index of the candidate, lower than `SolverCandidates`.
+ * @return The lowercase word, as long as the word of the game and not null-terminated.
+ */
+const char *SolverCandidate(const Solver *solver, size_t candidate) {
+    size_t word = solver->all ? candidate : solver->candidates[candidate];
+    return (const char *)(solver->group->rows + word * (solver->group->stride / 8));
+}
+
+/**
+ * @brief Suggests the next letter to guess.
+ * 
+ * The letter not guessed yet that most candidates contain is the one most
+ * likely to be a hit; ties go to the letter that is more common in English,
+ * which alone decides when no candidate is left.
+ * 
+ * @param solver The solver, following the game.
+ * @param game The game.
+ * @return The lowercase letter, or 0 if every letter has been guessed.
+ */
+char SolverHint(Solver *solver, const Game *game) {
+    SolverSync(solver, game);
+    bool candidates = SolverCandidates(solver) > 0;
+    uint64_t bestScore = 0;
+    int best = -1;
+    for (int letter = 0; letter < 26; letter++) {
+        if (game->guessed & ((uint32_t)1 << letter)) {
+            continue;
+        }
+        uint64_t score = (candidates ? (uint64_t)solver->frequencies[letter] << 8 : 0) + LetterFrequency[letter] + 1;
+        if (score > bestScore) {
+            bestScore = score;
+            best = letter;
+        }
+    }
+    return best < 0 ? 0 : (char)('a' + best);
+}
+
+/**
+ * @brief Decides the next guess of the computer player.
+ * 
+ * When only one candidate is left the whole word is guessed, otherwise the
+ * letter of `SolverHint`.
+ * 
+ * @param solver The solver, following the game.
+ * @param game The game, which is not over.
+ * @param guess Filled with the guess, to be applied with `GameApplyGuess`.
+ */
+void SolverNextGuess(Solver *solver, const Game *game, ParsedGuess *guess) {
+    SolverSync(solver, game);
+    if (SolverCandidates(solver) == 1) {
+        guess->kind = INPUT_WORD;
+        guess->word = SolverCandidate(solver, 0);
+        guess->length = game->length;
+        guess->letter = guess->word[0];
+        solver->proposed = true;
+        return;
+    }
+    guess->letter = SolverHint(solver, game);
+    guess->kind = guess->letter != 0 ? INPUT_LETTER : INPUT_INVALID;
+    guess->word = NULL;
+    guess->length = 1;
+}
+
+/**
+ * @brief Size of a cache line, the alignment of every record in a `Pool`.
+ */
+#define CACHE_LINE 64
+
+/**
+ * @brief Allocator of fixed-size records, for example games.
+ * 
+ * Records are carved out of large slabs and are aligned to and padded to
+ * whole cache lines, so two records never share a line. Released records go
+ * onto a free list and are handed out again before a new slab is allocated,
+ * so after warming up allocating and releasing a record never reaches the
+ * general allocator. A pool is not thread-safe; every thread uses its own.
+ */
+typedef struct {
+    size_t size;            // Bytes per record, a multiple of CACHE_LINE
+    size_t perSlab;         // Records per slab
+    void *free;             // First released record, each holds the next one
+    void **slabs;           // Start of every slab, as returned by the allocator
+    size_t slabCount;       // Number of slabs
+    size_t slabCapacity;    // Entries allocated for slabs
+} Pool;
+
+/**
+ * @brief Initializes an empty pool.
+ * 
+ * @param pool The pool to initialize.
+ * @param size Size of one record in bytes.
+ * @param perSlab Number of records allocated at once when the pool runs empty.
+ */
+void PoolInit(Pool *pool, size_t size, size_t perSlab) {
+    if (size < sizeof(void *)) {
+        size = sizeof(void *);
+    }
+    pool->size = (size + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+    pool->perSlab = perSlab;
+    pool->free = NULL;
+    pool->slabs = NULL;
+    pool->slabCount = pool->slabCapacity = 0;
+}
+
+/**
+ * @brief Takes a record from the pool, allocating a new slab if none is free.
+ * 
+ * @param pool The pool.
+ * @return The record, aligned to a cache line. Its contents are undefined.
+ */
+void *PoolAlloc(Pool *pool) {
+    if (pool->free == NULL) {
+        if (pool->slabCount == pool->slabCapacity) {
+            pool->slabCapacity = pool->slabCapacity ? pool->slabCapacity * 2 : 8;
+            pool->slabs = ReallocOrExit(pool->slabs, pool->slabCapacity * sizeof(void *));
+        }
+        char *slab = ReallocOrExit(NULL, pool->size * pool->perSlab + CACHE_LINE);
+        pool->slabs[pool->slabCount++] = slab;
+        // Align the first record and chain all records of the slab together
+        char *record = slab + (CACHE_LINE - (uintptr_t)slab % CACHE_LINE) % CACHE_LINE;
+        for (size_t i = 0; i < pool->perSlab; i++, record += pool->size) {
+            *(void **)record = pool->free;
+            pool->free = record;
+        }
+    }
+    void *record = pool->free;
+    pool->free = *(void **)record;
+    return record;
+}
+
+/**
+ * @brief Gives a record back to the pool.
+ * 
+ * @param pool The pool the record was taken from.
+ * @param record The record, or NULL.
+ */
+void PoolRelease(Pool *pool, void *record) {
+    if (record != NULL) {
+        *(void **)record = pool->free;
+        pool->free = record;
+    }
+}
+
+/**
+ * @brief Frees all slabs of the pool, including records still in use.
+ * 
+ * @param pool The pool to free.
+ */
+void PoolFree(Pool *pool) {
+    for (size_t i = 0; i < pool->slabCount; i++) {
+        free(pool->slabs[i]);
+    }
+    free(pool->slabs);
+    pool->free = NULL;
+    pool->slabs = NULL;
+    pool->slabCount = pool->slabCapacity = 0;
+}
+
+/**
+ * @brief Selects a random word from the dictionary based on the number of words.
+ * 
+ * This function selects a random index into the dictionary and copies the word stored
+ * there, so the file does not have to be read up to the randomly selected line.
+ * 
+ * @param dict The dictionary loaded from the word file.
+ * @param rng The random number generator, seeded once at startup.
+ * @param NumOfLines The total number of words in the dictionary, used to determine the range for random selection.
+ * @param selectedword Buffer to store the selected word.
+ */
+void SelectWord(const Dictionary *dict, Rng *rng, size_t NumOfLines, char selectedword[MAX_LENGTH]){
+    uint64_t start = StatStart();
+    size_t randomLine = RngBounded(rng, NumOfLines);   // Random num from array
+
+    memcpy(selectedword, DictionaryWord(dict, randomLine), DictionaryWordLength(dict, randomLine) + 1);
+    StatStop(STAT_SELECT, start);
+}
+
+/**
+ * @brief Counts the words of the dictionary that satisfy a filter.
+ * 
+ * Only the sizes of the matching buckets are added up, except for a length of
+ * `WORD_BUCKET_LENGTHS - 1` or more, whose buckets hold words of several
+ * lengths and are scanned.
+ * 
+ * @param dict The dictionary.
+ * @param filter The constraints the words must satisfy.
+ * @return The number of matching words.
+ */
+size_t DictionaryCountMatching(const Dictionary *dict, const WordFilter *filter) {
+    size_t matching = 0;
+    size_t first = filter->length, last = filter->length == 0 ? WORD_BUCKET_LENGTHS - 1 : filter->length;
+    for (int difficulty = 0; difficulty < DIFFICULTIES; difficulty++) {
+        if (filter->difficulty != DIFFICULTY_ANY && filter->difficulty != (Difficulty)difficulty) {
+            continue;
+        }
+        if (filter->length >= WORD_BUCKET_LENGTHS - 1) {
+            const WordBucket *bucket = &dict->buckets[WordBucketOf(filter->length, difficulty)];
+            for (size_t i = 0; i < bucket->count; i++) {
+                matching += DictionaryWordLength(dict, BucketWord(bucket, i)) == filter->length;
+            }
+            continue;
+        }
+        for (size_t length = first; length <= last; length++) {
+            matching += dict->buckets[WordBucketOf(length, difficulty)].count;
+        }
+    }
+    return matching;
+}
+
+/**
+ * @brief Selects a random word satisfying a filter from the dictionary.
+ * 
+ * Only the sizes of the buckets matching the filter are looked at to pick a
+ * word uniformly among all matching words, so the selection takes the same
+ * time no matter how many words the dictionary holds. Only a length of
+ * `WORD_BUCKET_LENGTHS - 1` or more, whose buckets hold words of several
+ * lengths, is picked by sampling the words of those buckets.
+ * 
+ * @param dict The dictionary loaded from the word file.
+ * @param rng The random number generator, seeded once at startup.
+ * @param filter The constraints the word must satisfy.
+ * @param selectedword Buffer to store the selected word.
+ * @return true if a word was selected, false if no word satisfies the filter.
+ */
+bool SelectWordMatching(const Dictionary *dict, Rng *rng, const WordFilter *filter, char selectedword[MAX_LENGTH]){
+    uint64_t start = StatStart();
+    size_t first = filter->length, last = filter->length, matching = 0;
+    if (filter->length == 0 || filter->length >= WORD_BUCKET_LENGTHS) {
+        last = WORD_BUCKET_LENGTHS - 1;
+        first = first < last ? first : last;
+    }
+    if (filter->length >= WORD_BUCKET_LENGTHS - 1) {
+        // The buckets of the longest length hold words of many lengths, sample among the matching ones
+        size_t picked = 0;
+        for (int difficulty = 0; difficulty < DIFFICULTIES; difficulty++) {
+            const WordBucket *bucket = &dict->buckets[WordBucketOf(last, difficulty)];
+            if (filter->difficulty != DIFFICULTY_ANY && filter->difficulty != (Difficulty)difficulty) {
+                continue;
+            }
+            for (size_t i = 0; i < bucket->count; i++) {
+                if (DictionaryWordLength(dict, BucketWord(bucket, i)) == filter->length && RngBounded(rng, ++matching) == 0) {
+                    picked = BucketWord(bucket, i);
+                }
+            }
+        }
+        if (matching > 0) {
+            memcpy(selectedword, DictionaryWord(dict, picked), filter->length + 1);
+            StatStop(STAT_SELECT, start);
+        }
+        return matching > 0;
+    }
+    matching = DictionaryCountMatching(dict, filter);
+    if (matching == 0) {
+        return false;
+    }
+    size_t pick = RngBounded(rng, matching);
+    for (size_t length = first; length <= last; length++) {
+        for (int difficulty = 0; difficulty < DIFFICULTIES; difficulty++) {
+            const WordBucket *bucket = &dict->buckets[WordBucketOf(length, difficulty)];
+            if (filter->difficulty != DIFFICULTY_ANY && filter->difficulty != (Difficulty)difficulty) {
+                continue;
+            }
+            if (pick < bucket->count) {
+                size_t index = BucketWord(bucket, pick);
+                memcpy(selectedword, DictionaryWord(dict, index), DictionaryWordLength(dict, index) + 1);
+                StatStop(STAT_SELECT, start);
+                return true;
+            }
+            pick -= bucket->count;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Samples the words of a file in a single pass, continuing a reservoir sample.
+ * 
+ * The file is scanned once with `NextWord` over a memory view of it: the k-th
+ * matching word seen so far replaces the current pick with probability 1/k,
+ * which leaves every word equally likely to be selected without counting the
+ * words first, also across several files. Words that do not satisfy the
+ * filter are skipped without being counted.
+ * 
+ * @param filename Name of the file with one word per line.
+ * @param rng The random number generator, seeded once at startup.
+ * @param filter The constraints the word must satisfy, or NULL for none.
+ * @param seen Number of matching words sampled before, updated.
+ * @param selectedword The current pick, replaced if a word of this file is picked.
+ */
+void SampleWordFile(const char *filename, Rng *rng, const WordFilter *filter, uint64_t *seen, char selectedword[MAX_LENGTH]){
+    MappedFile map;
+    if (!MappedFileOpen(&map, filename)) {
+        return;
+    }
+    size_t pos = 0, length; const char *word;
+    while (NextWord(map.data, map.size, &pos, &word, &length)) {
+        if (!WordMatches(filter, word, length)) {
+            continue;
+        }
+        (*seen)++;
+        if (RngBounded(rng, *seen) == 0) {
+            memcpy(selectedword, word, length);
+            selectedword[length] = '\0';
+        }
+    }
+    MappedFileClose(&map);
+}
+
+/**
+ * @brief Selects a random word from the file in a single pass.
+ * 
+ * Used when the dictionary is not preloaded, see `SampleWordFile`. Because
+ * there is only one pass, the pick stays consistent even if the file is
+ * replaced while it is being read.
+ * 
+ * @param filename Name of the file with one word per line.
+ * @param rng The random number generator, seeded once at startup.
+ * @param filter The constraints the word must satisfy, or NULL for none.
+ * @param selectedword Buffer to store the selected word.
+ * @return true if a word was selected, false if the file holds no matching words.
+ */
+bool SelectWordStreaming(const char *filename, Rng *rng, const WordFilter *filter, char selectedword[MAX_LENGTH]){
+    uint64_t seen = 0;
+    uint64_t start = StatStart();
+    SampleWordFile(filename, rng, filter, &seen, selectedword);
+    StatStop(STAT_DICTIONARY_SCAN, start);
+    return seen > 0;
+}
+
+/**
+ * @brief Selects a random word satisfying a filter from all shards of the catalog.
+ * 
+ * Every shard is weighed by the number of its words that satisfy the filter,
+ * so every matching word is equally likely no matter which file holds it. A
+ * catalog with a single shard picks the same words as `SelectWord` and
+ * `SelectWordMatching` for the same generator. Without loaded shards the
+ * word files are sampled in a single pass each, like `SelectWordStreaming`.
+ * 
+ * @param catalog The catalog of word files.
+ * @param rng The random number generator, seeded once at startup.
+ * @param filter The constraints the word must satisfy, or NULL for none.
+ * @param selectedword Buffer to store the selected word.
+ * @return true if a word was selected, false if no word satisfies the filter.
+ */
+bool CatalogSelect(const Catalog *catalog, Rng *rng, const WordFilter *filter, char selectedword[MAX_LENGTH]){
+    if (!catalog->loaded) {
+        uint64_t seen = 0;
+        uint64_t start = StatStart();
+        for (size_t i = 0; i < catalog->count; i++) {
+            SampleWordFile(catalog->filenames[i], rng, filter, &seen, selectedword);
+        }
+        StatStop(STAT_DICTIONARY_SCAN, start);
+        return seen > 0;
+    }
+    if (filter == NULL || (filter->length == 0 && filter->difficulty == DIFFICULTY_ANY)) {
+        size_t count = CatalogCount(catalog), length;
+        if (count == 0) {
+            return false;
+        }
+        uint64_t start = StatStart();
+        const char *word = CatalogWord(catalog, RngBounded(rng, count), &length);
+        memcpy(selectedword, word, length + 1);
+        StatStop(STAT_SELECT, start);
+        return true;
+    }
+    if (catalog->count == 1) {
+        return SelectWordMatching(catalog->shards[0], rng, filter, selectedword);
+    }
+    size_t matching[CATALOG_MAX_SHARDS], total = 0;
+    for (size_t i = 0; i < catalog->count; i++) {
+        matching[i] = DictionaryCountMatching(catalog->shards[i], filter);
+        total += matching[i];
+    }
+    if (total == 0) {
+        return false;
+    }
+    size_t pick = RngBounded(rng, total), shard = 0;
+    while (pick >= matching[shard]) {
+        pick -= matching[shard++];
+    }
+    return SelectWordMatching(catalog->shards[shard], rng, filter, selectedword);
+}
+
+/**
+ * @brief Splits the next token separated by spaces or tabs off a string.
+ * 
+ * @param cursor Position in the string, moved past the token. The character
+ *        after the token is overwritten with '\0'.
+ * @return The token, or NULL at the end of the string.
+ */
+char *NextToken(char **cursor) {
+    char *start = *cursor + strspn(*cursor, " \t");
+    if (*start == '\0') {
+        *cursor = start;
+        return NULL;
+    }
+    char *end = start + strcspn(start, " \t");
+    *cursor = *end != '\0' ? end + 1 : end;
+    *end = '\0';
+    return start;
+}
+
+/**
+ * @brief Plays one recorded game through the engine and writes its outcome.
+ * 
+ * A record is either "word=<word>" or "seed=<n>" followed by the guesses,
+ * separated by spaces. The word must be one the word files could hold and
+ * the seed a decimal number. With a seed the word is selected from the catalog
+ * exactly as a game started with `--seed <n>` would. Guesses after the end of
+ * the game are ignored. The outcome line holds the word, "won", "lost" or
+ * "unfinished", the number of wrong guesses and the number of guesses used.
+ * 
+ * @param catalog The loaded catalog used for records with a seed.
+ * @param record The record, modified while it is parsed.
+ * @param game The game to play the record in, ended again before returning.
+ * @param out The file the outcome is written to.
+ * @return true if the record was played, false if it is invalid.
+ */
+bool ReplayGame(const Catalog *catalog, char *record, Game *game, FILE *out) {
+    char word[MAX_LENGTH];
+    char *cursor = record, *token = NextToken(&cursor);
+    if (token == NULL) {
+        return false;
+    }
+    if (strncmp(token, "word=", 5) == 0 && strlen(token + 5) < MAX_LENGTH && WordIsValid(token + 5, strlen(token + 5))) {
+        strcpy(word, token + 5);
+    } else if (strncmp(token, "seed=", 5) == 0 && isdigit((unsigned char)token[5])) {
+        Rng rng;
+        char *end;
+        uint64_t seed = strtoull(token + 5, &end, 10);
+        if (*end != '\0') {
+            return false;
+        }
+        RngSeed(&rng, seed);
+        if (!CatalogSelect(catalog, &rng, NULL, word)) {
+            return false;
+        }
+    } else {
+        return false;
+    }
+
+    GameStart(game, word);
+    size_t used = 0;
+    while (!GameIsWon(game) && !GameIsLost(game) && (token = NextToken(&cursor)) != NULL) {
+        ParsedGuess guess;
+        ParseGuess(token, &guess);
+        if (GameApplyGuess(game, &guess) != GUESS_INVALID) {
+            used++;
+        }
+    }
+    fprintf(out, "%s %s %d %zu\n", GameWord(game),
+            GameIsWon(game) ? "won" : GameIsLost(game) ? "lost" : "unfinished", game->state, used);
+    GameEnd(game);
+    return true;
+}
+
+/**
+ * @brief Replays recorded games as fast as possible, without rendering anything.
+ * 
+ * Reads one record per line (see `ReplayGame`), skipping empty lines and lines
+ * starting with '#', and writes one outcome line per record. Invalid records
+ * are reported as "invalid <line>". A summary is printed to standard error.
+ * 
+ * @param catalog The loaded catalog used for records with a seed.
+ * @param in The file with the records.
+ * @param out The file the outcomes are written to.
+ */
+void ReplayGames(const Catalog *catalog, FILE *in, FILE *out) {
+    char record[4096]; bool truncated; Game game;
+    size_t line = 0, games = 0, won = 0, lost = 0, invalid = 0;
+
+    while (ReadLine(in, record, sizeof(record), &truncated)) {
+        line++;
+        if (record[0] == '\0' || record[0] == '#') {
+            continue;
+        }
+        if (truncated || !ReplayGame(catalog, record, &game, out)) {
+            fprintf(out, "invalid %zu\n", line);
+            invalid++;
+            continue;
+        }
+        games++;
+        won += GameIsWon(&game);
+        lost += GameIsLost(&game);
+    }
+    fflush(out);
+    fprintf(stderr, "Replayed %zu games: %zu won, %zu lost, %zu invalid records.\n", games, won, lost, invalid);
+}
+
+#define SIMULATION_MAX_THREADS 256
+#define SIMULATION_MISTAKES 10
+#define SIMULATION_DECISION_BITS 10
+#define SIMULATION_DECISIONS (1 << SIMULATION_DECISION_BITS)
+#define SIMULATION_DECISION_PROBES 8
+
+/**
+ * @brief Outcome of all simulated games of one word.
+ */
+typedef struct {
+    uint32_t games;     // Games played
+    uint32_t won;       // Games won by the solver
+    uint64_t wrong;     // Wrong guesses of all games
+    uint64_t guesses;   // Guesses of all games
+} SimulationResult;
+
+typedef struct Simulation Simulation;
+
+/**
+ * @brief A thread of a simulation with the words it has left to play.
+ * 
+ * The words left are one range packed into a single atomic word, so the
+ * worker takes words from its front while idle workers steal the back half
+ * of it, both with a compare-and-swap and without a lock.
+ */
+typedef struct {
+    atomic_uint_fast64_t range;     // Next word in the low 32 bits, end of the words in the high 32 bits
+    Simulation *simulation;         // The simulation the worker belongs to
+    size_t id;                      // Index of the worker
+    uint64_t games;                 // Games played by the worker
+#ifdef HANGMAN_HAVE_THREADS
+    pthread_t thread;               // Thread of the worker, the first worker runs on the calling thread
+#endif
+    char padding[CACHE_LINE];       // Keeps the ranges of two workers out of the same cache line
+} SimulationWorker;
+
+/**
+ * @brief Self-play of the solver against every word of a catalog.
+ */
+struct Simulation {
+    const Catalog *catalog;         // Words to play
+    const SolverIndex *index;       // Words the solvers know
+    SimulationResult *results;      // Result of every word of the catalog
+    SimulationWorker *workers;      // The workers
+    size_t threads;                 // Number of workers
+    uint32_t games;                 // Games per word
+    unsigned mistakes;              // Percentage of random guesses instead of the solver's
+    uint64_t seed;                  // Seed of the random guesses, mixed with every word
+};
+
+/**
+ * @brief Takes the next word from the front of a worker's own range.
+ * 
+ * @param worker The worker.
+ * @param word Set to the index of the word.
+ * @return true if a word was taken, false if the range is empty.
+ */
+bool SimulationTake(SimulationWorker *worker, size_t *word) {
+    uint_fast64_t range = atomic_load_explicit(&worker->range, memory_order_relaxed);
+    do {
+        if ((uint32_t)range >= range >> 32) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&worker->range, &range, range + 1,
+                                                    memory_order_relaxed, memory_order_relaxed));
+    *word = (uint32_t)range;
+    return true;
+}
+
+/**
+ * @brief Moves the back half of another worker's words into an idle worker's range.
+ * 
+ * @param worker The worker, whose own range is empty.
+ * @return true if words were stolen, false if no worker has any left.
+ */
+bool SimulationSteal(SimulationWorker *worker) {
+    Simulation *simulation = worker->simulation;
+    for (size_t i = 1; i < simulation->threads; i++) {
+        SimulationWorker *victim = &simulation->workers[(worker->id + i) % simulation->threads];
+        uint_fast64_t range = atomic_load_explicit(&victim->range, memory_order_relaxed);
+        uint64_t begin, end, middle;
+        do {
+            begin = (uint32_t)range;
+            end = range >> 32;
+            if (begin >= end) {
+                break;
+            }
+            middle = begin + (end - begin) / 2;
+        } while (!atomic_compare_exchange_weak_explicit(&victim->range, &range, middle << 32 | begin,
+                                                        memory_order_relaxed, memory_order_relaxed));
+        if (begin < end) {
+            atomic_store_explicit(&worker->range, end << 32 | middle, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief A decision of the solver, remembered for the other games of the same word.
+ * 
+ * The board follows from the word and the letters guessed, and the solver's
+ * choice from the board, so within the games of one word the guessed
+ * letters alone identify a decision.
+ */
+typedef struct {
+    uint32_t word;      // Index of the word plus one, any other value marks a free entry
+    uint32_t guessed;   // Letters guessed before the decision
+    char letter;        // The letter the solver guessed, or 0 if it guessed the whole word
+} SimulationDecision;
+
+/**
+ * @brief Finds the entry of a decision, or the free entry to remember it in.
+ * 
+ * @param decisions The `SIMULATION_DECISIONS` decisions of the worker.
+ * @param word Index of the word plus one.
+ * @param guessed Letters guessed before the decision.
+ * @return The entry, or NULL if the decision is not known and there is no room.
+ */
+SimulationDecision *SimulationDecisionFind(SimulationDecision *decisions, uint32_t word, uint32_t guessed) {
+    size_t slot = (guessed * 0x9E3779B1u) >> (32 - SIMULATION_DECISION_BITS);
+    for (size_t probe = 0; probe < SIMULATION_DECISION_PROBES; probe++) {
+        SimulationDecision *decision = &decisions[(slot + probe) & (SIMULATION_DECISIONS - 1)];
+        if (decision->word != word || decision->guessed == guessed) {
+            return decision;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Decides the next guess of a simulated player.
+ * 
+ * In `mistakes` percent of the guesses a random letter not guessed yet is
+ * guessed instead of the solver's choice, which is what makes games of the
+ * same word play out differently. The solver's choices are remembered, so
+ * it only filters its candidates when a game reaches a state no earlier
+ * game of the word has been in.
+ * 
+ * @param simulation The simulation.
+ * @param solver The solver, following the game.
+ * @param decisions The remembered decisions of the worker.
+ * @param word Index of the word plus one.
+ * @param game The game, which is not over.
+ * @param rng Generator of the random guesses.
+ * @param guess Filled with the guess.
+ */
+void SimulationGuess(const Simulation *simulation, Solver *solver, SimulationDecision *decisions, uint32_t word,
+                     const Game *game, Rng *rng, ParsedGuess *guess) {
+    uint32_t unguessed = ~game->guessed & (((uint32_t)1 << 26) - 1);
+    if (simulation->mistakes == 0 || unguessed == 0 || RngBounded(rng, 100) >= simulation->mistakes) {
+        SimulationDecision *decision = SimulationDecisionFind(decisions, word, game->guessed);
+        if (decision != NULL && decision->word == word) {
+            guess->kind = decision->letter != 0 ? INPUT_LETTER : INPUT_WORD;
+            guess->letter = decision->letter;
+            guess->word = decision->letter != 0 ? NULL : GameWord(game);
+            guess->length = decision->letter != 0 ? 1 : game->length;
+            return;
+        }
+        SolverNextGuess(solver, game, guess);
+        if (decision != NULL && guess->kind != INPUT_INVALID) {
+            decision->word = word;
+            decision->guessed = game->guessed;
+            decision->letter = guess->kind == INPUT_LETTER ? guess->letter : 0;
+        }
+        return;
+    }
+    uint64_t left = 0;
+    for (uint32_t bits = unguessed; bits != 0; bits &= bits - 1) {
+        left++;
+    }
+    uint64_t pick = RngBounded(rng, left);
+    int letter = 0;
+    for (;; letter++) {
+        if ((unguessed & ((uint32_t)1 << letter)) && pick-- == 0) {
+            break;
+        }
+    }
+    guess->kind = INPUT_LETTER;
+    guess->letter = (char)('a' + letter);
+    guess->word = NULL;
+    guess->length = 1;
+}
+
+/**
+ * @brief Plays all games of one word.
+ * 
+ * Without mistakes the solver plays every game of a word the same way, so
+ * only one is played and counted as all of them.
+ * 
+ * @param simulation The simulation.
+ * @param solver The solver of the worker.
+ * @param decisions The remembered decisions of the worker.
+ * @param index Index of the word in the catalog.
+ * @return The number of games actually played.
+ */
+uint64_t SimulationPlay(const Simulation *simulation, Solver *solver, SimulationDecision *decisions, size_t index) {
+    SimulationResult *result = &simulation->results[index];
+    size_t length;
+    const char *word = CatalogWord(simulation->catalog, index, &length);
+    uint32_t games = simulation->mistakes == 0 && simulation->games > 1 ? 1 : simulation->games;
+    Rng rng; Game game;
+    RngSeed(&rng, simulation->seed ^ HashWord(word, length));
+
+    for (uint32_t i = 0; i < games; i++) {
+        GameStart(&game, word);
+        SolverStart(solver, &game);
+        uint64_t guesses = 0;
+        while (!GameIsWon(&game) && !GameIsLost(&game)) {
+            ParsedGuess guess;
+            SimulationGuess(simulation, solver, decisions, (uint32_t)index + 1, &game, &rng, &guess);
+            if (GameApplyGuess(&game, &guess) == GUESS_INVALID) {
+                break;
+            }
+            guesses++;
+        }
+        result->won += GameIsWon(&game);
+        result->wrong += (uint64_t)game.state;
+        result->guesses += guesses;
+        GameEnd(&game);
+    }
+    if (games < simulation->games) {
+        result->won *= simulation->games;
+        result->wrong *= simulation->games;
+        result->guesses *= simulation->games;
+    }
+    result->games = simulation->games;
+    return games;
+}
+
+/**
+ * @brief Plays words until no worker has any left.
+ * 
+ * @param arg The `SimulationWorker`.
+ * @return NULL.
+ */
+void *SimulationRun(void *arg) {
+    SimulationWorker *worker = arg;
+    SimulationDecision *decisions = ReallocOrExit(NULL, SIMULATION_DECISIONS * sizeof(SimulationDecision));
+    Solver solver;
+    size_t word;
+    memset(decisions, 0, SIMULATION_DECISIONS * sizeof(SimulationDecision));
+    SolverInit(&solver, worker->simulation->index);
+    while (SimulationTake(worker, &word) || (SimulationSteal(worker) && SimulationTake(worker, &word))) {
+        worker->games += SimulationPlay(worker->simulation, &solver, decisions, word);
+    }
+    SolverFree(&solver);
+    free(decisions);
+    return NULL;
+}
+
+/**
+ * @brief Plays every word of a catalog against the solver and writes the results per word.
+ * 
+ * The words are split evenly between the threads, and threads that run out
+ * of words steal from the others, since long words take much longer than
+ * short ones. Nothing is rendered; the games go straight through the engine.
+ * Every word gets a line with the word, the number of games, the games won,
+ * the average number of wrong guesses and the average number of guesses, in
+ * the order of the catalog. A summary is printed to standard error.
+ * 
+ * @param catalog The loaded catalog.
+ * @param games Games per word.
+ * @param mistakes Percentage of random guesses, from 0 to 100.
+ * @param seed Seed of the random guesses.
+ * @param threads Number of threads, 0 for one per core.
+ * @param out The file the results are written to.
+ */
+void SimulateGames(const Catalog *catalog, uint32_t games, unsigned mistakes, uint64_t seed, size_t threads, FILE *out) {
+    Simulation simulation;
+    SolverIndex index;
+    size_t words = CatalogCount(catalog);
+    uint64_t start = NowNanoseconds(), played = 0, total = 0, won = 0;
+    if (words >= UINT32_MAX) {
+        fprintf(stderr, "Too many words to simulate, at most %u\n", UINT32_MAX);
+        return;
+    }
+#ifdef HANGMAN_HAVE_THREADS
+    if (threads == 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 1 ? (size_t)cores : 1;
+    }
+#else
+    threads = 1;
+#endif
+    threads = threads < 1 ? 1 : threads > SIMULATION_MAX_THREADS ? SIMULATION_MAX_THREADS : threads;
+
+    SolverIndexInit(&index);
+    SolverIndexBuild(&index, catalog->shards, catalog->count);
+    SolverIndexBuildPatterns(&index);
+    simulation.catalog = catalog;
+    simulation.index = &index;
+    simulation.results = ReallocOrExit(NULL, (words > 0 ? words : 1) * sizeof(SimulationResult));
+    memset(simulation.results, 0, (words > 0 ? words : 1) * sizeof(SimulationResult));
+    simulation.workers = ReallocOrExit(NULL, threads * sizeof(SimulationWorker));
+    simulation.threads = threads;
+    simulation.games = games;
+    simulation.mistakes = mistakes > 100 ? 100 : mistakes;
+    simulation.seed = seed;
+    for (size_t i = 0; i < threads; i++) {
+        SimulationWorker *worker = &simulation.workers[i];
+        uint64_t begin = words * i / threads, end = words * (i + 1) / threads;
+        atomic_init(&worker->range, end << 32 | begin);
+        worker->simulation = &simulation;
+        worker->id = i;
+        worker->games = 0;
+    }
+
+#ifdef HANGMAN_HAVE_THREADS
+    bool started[SIMULATION_MAX_THREADS] = { false };
+    for (size_t i = 1; i < threads; i++) {
+        started[i] = pthread_create(&simulation.workers[i].thread, NULL, SimulationRun, &simulation.workers[i]) == 0;
+    }
+    SimulationRun(&simulation.workers[0]);     // Also plays the words of workers that did not start
+    for (size_t i = 1; i < threads; i++) {
+        if (started[i]) {
+            pthread_join(simulation.workers[i].thread, NULL);
+        }
+    }
+#else
+    SimulationRun(&simulation.workers[0]);
+#endif
+    double seconds = (double)(NowNanoseconds() - start) / 1e9;
+
+    for (size_t i = 0; i < words; i++) {
+        const SimulationResult *result = &simulation.results[i];
+        size_t length;
+        const char *word = CatalogWord(catalog, i, &length);
+        fprintf(out, "%s %u %u %.2f %.2f\n", word, result->games, result->won,
+                result->games > 0 ? (double)result->wrong / result->games : 0.0,
+                result->games > 0 ? (double)result->guesses / result->games : 0.0);
+        total += result->games;
+        won += result->won;
+    }
+    for (size_t i = 0; i < threads; i++) {
+        played += simulation.workers[i].games;
+    }
+    fflush(out);
+    fprintf(stderr, "Simulated %llu games of %zu words on %zu threads in %.2f s: %.1f%% won, %.0f games played per second.\n",
+            (unsigned long long)total, words, threads, seconds, total > 0 ? 100.0 * won / total : 0.0,
+            seconds > 0 ? played / seconds : 0.0);
+
+    free(simulation.workers);
+    free(simulation.results);
+    SolverIndexFree(&index);
+}
+
+#define PLAYERS_EXTENSION ".players"
+#define PLAYER_LOG_EXTENSION ".results"
+#define PLAYERS_MAGIC "HANGPLYR"
+#define PLAYER_LOG_MAGIC "HANGRSLT"
+#define PLAYER_NAME_MAX 31
+#define PLAYER_FLUSH_RESULTS 256
+#define PLAYER_SNAPSHOT_RESULTS 65536
+#define PLAYER_TOP 10
+#define PLAYER_LINE 512
+#define PLAYER_DEFAULT "player"
+
+/**
+ * @brief Header of both the snapshot of the players and the log of results.
+ * 
+ * The log belongs to the snapshot with the same generation. A log of an older
+ * generation was written before the snapshot was taken, so its results are
+ * part of the snapshot already and it is ignored.
+ */
+typedef struct {
+    char magic[8];          // PLAYERS_MAGIC or PLAYER_LOG_MAGIC
+    uint64_t generation;    // Number of snapshots taken before this one
+    uint64_t count;         // Players in the snapshot, 0 in the log
+    uint64_t checksum;      // CompiledChecksum of the players in the snapshot, 0 in the log
+} PlayersHeader;
+
+/**
+ * @brief Statistics of one player, as kept in memory and in the snapshot.
+ */
+typedef struct {
+    char name[PLAYER_NAME_MAX + 1];     // Null-terminated name, padded with zeros
+    uint32_t games;                     // Games finished
+    uint32_t wins;                      // Games won
+    uint32_t streak;                    // Games won in a row up to the last one
+    uint32_t bestStreak;                // Most games won in a row
+    uint64_t wrongGuesses;              // Wrong guesses in all games
+} PlayerStats;
+
+/**
+ * @brief Result of one finished game, as appended to the log.
+ */
+typedef struct {
+    char name[PLAYER_NAME_MAX + 1];     // Null-terminated name of the player, padded with zeros
+    uint32_t won;                       // 1 if the game was won, 0 if it was lost
+    uint32_t checksum;                  // PlayerResultChecksum of the fields before
+    uint64_t wrongGuesses;              // Wrong guesses in the game
+} PlayerResult;
+
+/**
+ * @brief Statistics of all players, kept in memory and persisted in batches.
+ * 
+ * Finished games update the statistics in memory and are queued as results;
+ * nothing is written while a game is played or when it ends. The queued
+ * results are appended to the log in batches of `PLAYER_FLUSH_RESULTS` with
+ * a single sync, and once the log holds `PLAYER_SNAPSHOT_RESULTS` results a
+ * snapshot of all players replaces it. Opening the store loads the snapshot
+ * and replays the intact results of its log, so a crash loses at most the
+ * results that were still queued.
+ * 
+ * The statistics, the index and the queue are one unit; the files, `generation`
+ * and `logged` belong to whoever flushes, which may be another thread than the
+ * one recording results if it takes the queued results with `PlayerStoreTake`.
+ */
+typedef struct {
+    char filename[FILENAME_MAX];    // Name of the snapshot
+    char logname[FILENAME_MAX];     // Name of the log of results
+    FILE *log;                      // The log, opened for appending
+    uint64_t generation;            // Generation of the snapshot and the log
+    size_t logged;                  // Results in the log
+    PlayerStats *players;           // Statistics of every player
+    size_t count;                   // Number of players
+    size_t capacity;                // Players allocated
+    WordSet index;                  // Players by name
+    PlayerResult *pending;          // Results not written to the log yet
+    size_t pendingCount;            // Results in pending
+    size_t pendingCapacity;         // Results allocated for pending
+} PlayerStore;
+
+/**
+ * @brief Checks whether a name can be used for a player.
+ * 
+ * @param name The null-terminated name.
+ * @return true if the name has 1 to `PLAYER_NAME_MAX` letters, digits, '-', '_' or '.'.
+ */
+bool PlayerNameValid(const char *name) {
+    size_t length = strlen(name);
+    if (length == 0 || length > PLAYER_NAME_MAX) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '-' && name[i] != '_' && name[i] != '.') {
+            return false;
+        }
+    }
     return true;
+}
+
+/**
+ * @brief Computes the checksum of a result in the log.
+ * 
+ * @param result The result.
+ * @return The checksum of the name and the outcome.
+ */
+uint32_t PlayerResultChecksum(const PlayerResult *result) {
+    uint64_t hash = HashWord(result->name, sizeof(result->name))
+        ^ (result->wrongGuesses * 0x9E3779B97F4A7C15ULL) ^ result->won;
+    return (uint32_t)(hash ^ (hash >> 32));
+}
+
+/**
+ * @brief Finds the statistics of a player, adding the player if asked to.
+ * 
+ * @param store The store.
+ * @param name The valid, null-terminated name.
+ * @param create Whether to add a player who is not in the store yet.
+ * @return The statistics, or NULL if the player is unknown and not created.
+ *         The pointer is valid until the next player is added.
+ */
+PlayerStats *PlayerStoreFind(PlayerStore *store, const char *name, bool create) {
+    size_t length = strlen(name);
+    uint64_t hash = HashWord(name, length);
+    size_t mask = store->index.capacity - 1;
+    size_t slot = store->index.capacity > 0 ? hash & mask : 0;
+    while (store->index.capacity > 0 && store->index.slots[slot] != 0) {
+        PlayerStats *stats = &store->players[store->index.slots[slot] - 1];
+        if (strcmp(stats->name, name) == 0) {
+            return stats;
+        }
+        slot = (slot + 1) & mask;
+    }
+    if (!create) {
+        return NULL;
+    }
+    if (store->count == store->capacity) {
+        store->capacity = store->capacity ? store->capacity * 2 : 64;
+        store->players = ReallocOrExit(store->players, store->capacity * sizeof(PlayerStats));
+    }
+    if ((store->count + 1) * 2 > store->index.capacity) {
+        // Rebuild the index at twice the size, keeping it at most half full
+        size_t capacity = store->index.capacity ? store->index.capacity * 2 : 128;
+        free(store->index.slots);
+        store->index.slots = ReallocOrExit(NULL, capacity * sizeof(uint64_t));
+        memset(store->index.slots, 0, capacity * sizeof(uint64_t));
+        store->index.capacity = capacity;
+        mask = capacity - 1;
+        for (size_t i = 0; i < store->count; i++) {
+            const char *other = store->players[i].name;
+            size_t empty = HashWord(other, strlen(other)) & mask;
+            while (store->index.slots[empty] != 0) {
+                empty = (empty + 1) & mask;
+            }
+            store->index.slots[empty] = i + 1;
+        }
+        slot = hash & mask;
+        while (store->index.slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+    }
+    PlayerStats *stats = &store->players[store->count];
+    memset(stats, 0, sizeof(*stats));
+    memcpy(stats->name, name, length);
+    store->index.slots[slot] = ++store->count;
+    return stats;
+}
+
+/**
+ * @brief Updates the statistics of a player with the result of a game.
+ * 
+ * @param store The store.
+ * @param result The result of the game.
+ */
+void PlayerStoreApply(PlayerStore *store, const PlayerResult *result) {
+    PlayerStats *stats = PlayerStoreFind(store, result->name, true);
+    stats->games++;
+    stats->wrongGuesses += result->wrongGuesses;
+    if (result->won) {
+        stats->wins++;
+        if (++stats->streak > stats->bestStreak) {
+            stats->bestStreak = stats->streak;
+        }
+    } else {
+        stats->streak = 0;
+    }
+}
+
+/**
+ * @brief Starts a new, empty log for the current generation.
+ * 
+ * @param store The store.
+ */
+void PlayerLogRewrite(PlayerStore *store) {
+    PlayersHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PLAYER_LOG_MAGIC, sizeof(header.magic));
+    header.generation = store->generation;
+
+    char temporary[FILENAME_MAX + 32];
+    TemporaryFilename(temporary, sizeof(temporary), store->logname);
+    FILE *file;
+    FileOpenError(&file, temporary, "wb");
+    if (fwrite(&header, sizeof(header), 1, file) != 1) {
+        perror("Error writing file");
+        exit(1);
+    }
+    FileSync(file);
+    CloseFile(&file);
+    if (store->log != NULL) {
+        CloseFile(&store->log);
+    }
+#ifdef _WIN32
+    remove(store->logname);  // rename does not replace existing files on Windows
+#endif
+    if (rename(temporary, store->logname) != 0) {
+        perror("Error renaming file");
+        exit(1);
+    }
+    FileOpenError(&store->log, store->logname, "ab");
+    store->logged = 0;
+}
+
+/**
+ * @brief Replaces the snapshot with the given statistics and starts a new log.
+ * 
+ * The new snapshot is renamed over the old one before the log is replaced, so
+ * a crash in between leaves a log of the old generation, which is ignored.
+ * 
+ * @param store The store.
+ * @param players Statistics of all players, including every result written to the log.
+ * @param count Number of players.
+ */
+void PlayerStoreWriteSnapshot(PlayerStore *store, const PlayerStats *players, size_t count) {
+    PlayersHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PLAYERS_MAGIC, sizeof(header.magic));
+    header.generation = store->generation + 1;
+    header.count = count;
+    header.checksum = CompiledChecksum((const char *)players, count * sizeof(PlayerStats));
+
+    char temporary[FILENAME_MAX + 32];
+    TemporaryFilename(temporary, sizeof(temporary), store->filename);
+    FILE *file;
+    FileOpenError(&file, temporary, "wb");
+    if (fwrite(&header, sizeof(header), 1, file) != 1
+        || (count > 0 && fwrite(players, sizeof(PlayerStats), count, file) != count)) {
+        perror("Error writing file");
+        exit(1);
+    }
+    FileSync(file);
+    CloseFile(&file);
+#ifdef _WIN32
+    remove(store->filename);  // rename does not replace existing files on Windows
+#endif
+    if (rename(temporary, store->filename) != 0) {
+        perror("Error renaming file");
+        exit(1);
+    }
+    store->generation++;
+    PlayerLogRewrite(store);
+}
+
+/**
+ * @brief Appends results to the log with a single write and sync.
+ * 
+ * @param store The store.
+ * @param results The results, already applied to the statistics.
+ * @param count Number of results.
+ */
+void PlayerStoreWriteLog(PlayerStore *store, const PlayerResult *results, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (fwrite(results, sizeof(PlayerResult), count, store->log) != count) {
+        perror("Error writing file");
+        exit(1);
+    }
+    FileSync(store->log);
+    store->logged += count;
+}
+
+/**
+ * @brief Opens the store, loading the snapshot and replaying its log.
+ * 
+ * The files are derived from the first word file. A missing or corrupted
+ * snapshot starts the store empty. If results were replayed, or the log was
+ * missing, torn or of an older generation, a new snapshot is taken right away,
+ * so the log is always clean afterwards.
+ * 
+ * @param store The store to initialize.
+ * @param wordFile Name of the first word file.
+ */
+void PlayerStoreOpen(PlayerStore *store, const char *wordFile) {
+    memset(store, 0, sizeof(*store));
+    DerivedFilename(store->filename, sizeof(store->filename), wordFile, PLAYERS_EXTENSION);
+    DerivedFilename(store->logname, sizeof(store->logname), wordFile, PLAYER_LOG_EXTENSION);
+
+    MappedFile map;
+    PlayersHeader header;
+    if (MappedFileOpen(&map, store->filename)) {
+        if (map.size >= sizeof(header)) {
+            memcpy(&header, map.data, sizeof(header));
+        }
+        if (map.size >= sizeof(header) && memcmp(header.magic, PLAYERS_MAGIC, sizeof(header.magic)) == 0
+            && header.count == (map.size - sizeof(header)) / sizeof(PlayerStats)
+            && header.count * sizeof(PlayerStats) == map.size - sizeof(header)
+            && CompiledChecksum(map.data + sizeof(header), map.size - sizeof(header)) == header.checksum) {
+            store->generation = header.generation;
+            for (size_t i = 0; i < header.count; i++) {
+                PlayerStats stats;
+                memcpy(&stats, map.data + sizeof(header) + i * sizeof(stats), sizeof(stats));
+                stats.name[PLAYER_NAME_MAX] = '\0';
+                if (PlayerNameValid(stats.name)) {
+                    *PlayerStoreFind(store, stats.name, true) = stats;
+                }
+            }
+        }
+        MappedFileClose(&map);
+    }
+
+    bool clean = false;
+    if (MappedFileOpen(&map, store->logname)) {
+        if (map.size >= sizeof(header)) {
+            memcpy(&header, map.data, sizeof(header));
+        }
+        if (map.size >= sizeof(header) && memcmp(header.magic, PLAYER_LOG_MAGIC, sizeof(header.magic)) == 0
+            && header.generation == store->generation) {
+            size_t results = (map.size - sizeof(header)) / sizeof(PlayerResult), replayed = 0;
+            for (; replayed < results; replayed++) {
+                PlayerResult result;
+                memcpy(&result, map.data + sizeof(header) + replayed * sizeof(result), sizeof(result));
+                result.name[PLAYER_NAME_MAX] = '\0';
+                if (result.checksum != PlayerResultChecksum(&result) || !PlayerNameValid(result.name)) {
+                    break;      // A torn or corrupted result ends the log
+                }
+                PlayerStoreApply(store, &result);
+            }
+            clean = replayed == 0 && map.size == sizeof(header);
+        }
+        MappedFileClose(&map);
+    }
+    if (clean) {
+        FileOpenError(&store->log, store->logname, "ab");
+    } else {
+        PlayerStoreWriteSnapshot(store, store->players, store->count);
+    }
+}
+
+/**
+ * @brief Records the result of a finished game without any I/O.
+ * 
+ * @param store The store.
+ * @param name The valid, null-terminated name of the player.
+ * @param won Whether the player won.
+ * @param wrongGuesses Wrong guesses in the game.
+ * @return true if a batch of results is queued and should be flushed.
+ */
+bool PlayerStoreRecord(PlayerStore *store, const char *name, bool won, uint64_t wrongGuesses) {
+    PlayerResult result;
+    memset(&result, 0, sizeof(result));
+    memcpy(result.name, name, strlen(name));
+    result.won = won;
+    result.wrongGuesses = wrongGuesses;
+    result.checksum = PlayerResultChecksum(&result);
+    PlayerStoreApply(store, &result);
+    if (store->pendingCount == store->pendingCapacity) {
+        store->pendingCapacity = store->pendingCapacity ? store->pendingCapacity * 2 : PLAYER_FLUSH_RESULTS;
+        store->pending = ReallocOrExit(store->pending, store->pendingCapacity * sizeof(PlayerResult));
+    }
+    store->pending[store->pendingCount++] = result;
+    return store->pendingCount >= PLAYER_FLUSH_RESULTS;
+}
+
+/**
+ * @brief Takes the queued results, so they can be written without holding up new ones.
+ * 
+ * The queue is swapped with the buffer of the caller, which gets the queued
+ * results and leaves its own buffer for the results recorded next.
+ * 
+ * @param store The store.
+ * @param buffer Buffer of the caller, replaced by the queued results.
+ * @param capacity Results allocated for the buffer, replaced by those of the queued results.
+ * @return Number of results taken.
+ */
+size_t PlayerStoreTake(PlayerStore *store, PlayerResult **buffer, size_t *capacity) {
+    size_t count = store->pendingCount;
+    PlayerResult *results = store->pending;
+    size_t allocated = store->pendingCapacity;
+    store->pending = *buffer;
+    store->pendingCapacity = *capacity;
+    store->pendingCount = 0;
+    *buffer = results;
+    *capacity = allocated;
+    return count;
+}
+
+/**
+ * @brief Writes the queued results to the log and takes a snapshot when the log is long.
+ * 
+ * Only for a store that records and flushes on the same thread.
+ * 
+ * @param store The store.
+ */
+void PlayerStoreFlush(PlayerStore *store) {
+    PlayerStoreWriteLog(store, store->pending, store->pendingCount);
+    store->pendingCount = 0;
+    if (store->logged >= PLAYER_SNAPSHOT_RESULTS) {
+        PlayerStoreWriteSnapshot(store, store->players, store->count);
+    }
+}
+
+/**
+ * @brief Flushes the store and frees it.
+ * 
+ * @param store The store.
+ */
+void PlayerStoreClose(PlayerStore *store) {
+    PlayerStoreFlush(store);
+    CloseFile(&store->log);
+    free(store->players);
+    free(store->index.slots);
+    free(store->pending);
+}
+
+/**
+ * @brief Checks whether a player ranks before another one on the leaderboard.
+ * 
+ * Players are ranked by wins, then by fewer games, then by name.
+ * 
+ * @param a A player.
+ * @param b Another player.
+ * @return true if `a` ranks before `b`.
+ */
+bool PlayerRanksBefore(const PlayerStats *a, const PlayerStats *b) {
+    if (a->wins != b->wins) {
+        return a->wins > b->wins;
+    }
+    if (a->games != b->games) {
+        return a->games < b->games;
+    }
+    return strcmp(a->name, b->name) < 0;
+}
+
+/**
+ * @brief Copies the best players of the store, best first.
+ * 
+ * One pass over all players keeps the best `count` in order, so the
+ * leaderboard takes O(players * count) without sorting everyone.
+ * 
+ * @param store The store.
+ * @param top Buffer of `count` statistics to fill.
+ * @param count Number of players to return at most.
+ * @return Number of players returned.
+ */
+size_t PlayerStoreTop(const PlayerStore *store, PlayerStats *top, size_t count) {
+    size_t found = 0;
+    for (size_t i = 0; i < store->count; i++) {
+        const PlayerStats *stats = &store->players[i];
+        if (found == count && !PlayerRanksBefore(stats, &top[count - 1])) {
+            continue;
+        }
+        size_t at = found < count ? found++ : count - 1;
+        while (at > 0 && PlayerRanksBefore(stats, &top[at - 1])) {
+            top[at] = top[at - 1];
+            at--;
+        }
+        top[at] = *stats;
+    }
+    return found;
+}
+
+/**
+ * @brief Formats the statistics of a player as one line of the leaderboard.
+ * 
+ * @param line Buffer to store the line, including the newline.
+ * @param rank Place of the player, starting at 1.
+ * @param stats The statistics.
+ */
+void PlayerStatsLine(char line[PLAYER_LINE], size_t rank, const PlayerStats *stats) {
+    snprintf(line, PLAYER_LINE, "%zu. %.*s: %u wins in %u games, best streak %u, %.1f wrong guesses per game\n",
+             rank, PLAYER_NAME_MAX, stats->name, stats->wins, stats->games, stats->bestStreak,
+             stats->games > 0 ? (double)stats->wrongGuesses / stats->games : 0.0);
 }
\ No newline at end of file
@@ -0,0 +1,1259 @@
+#include <stdarg.h>
+#if defined(__unix__) || defined(__APPLE__)
+#define HANGMAN_HAVE_SERVER
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#ifdef __linux__
+#include <sys/epoll.h>
+#else
+#include <poll.h>
+#endif
+#endif
+#define SERVER_PORT 4242
+#define SERVER_THREADS 4
+#define SESSION_INPUT (MAX_LENGTH + 64)
+#define SESSION_OUTPUT (MAX_LENGTH * 2 + 256)
+#define SERVER_EVENTS 256
+#define SERVER_POOL_SLAB 256
+#define SERVER_STATS_INTERVAL 60
+#define SERVER_COMPACT_INTERVAL 10
+#define WORD_LOG_CHUNKS 40
+#define WORD_LOG_FIRST_CHUNK 1024
+#define WORD_LOG_BLOCK 65536
+
+#ifdef HANGMAN_HAVE_SERVER
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+/**
+ * @brief Append-only list of words added while the dictionary is shared.
+ *
+ * Chunk `k` holds `WORD_LOG_FIRST_CHUNK << k` words and, once allocated, never
+ * moves, and neither do the words, which live in blocks that are only ever
+ * appended to. A writer fills in a new word completely before it publishes
+ * the new count with a release store, so a reader that loads the count with
+ * an acquire load can read every word below it without taking a lock, and
+ * nothing a reader may still look at is ever freed while the log is in use.
+ */
+typedef struct {
+    const char **chunks[WORD_LOG_CHUNKS];   // Words of the log, allocated on demand
+    atomic_size_t count;                    // Number of published words
+    char *block;                            // Block new words are copied into
+    size_t blockUsed;                       // Bytes used in block
+    WordSet index;                          // Hash index of the log, used by writers only
+} WordLog;
+
+/**
+ * @brief Shards of the word files at one point in time.
+ *
+ * Words of the log below `logStart` had been compacted into the first word
+ * file before it was loaded, so they are part of its shard already. Shards
+ * that did not change are shared with the previous generation and handed
+ * over to the new one.
+ */
+typedef struct {
+    Catalog catalog;                    // Shards of the word files, the names belong to SharedDictionary.files
+    size_t logStart;                    // Words of the log that are in the first shard too
+    bool owned[CATALOG_MAX_SHARDS];     // Shard was loaded by a reload and is freed with the generation
+} DictionaryGeneration;
+
+/**
+ * @brief Dictionary shared by many threads while words are being added.
+ *
+ * Loaded shards are not changed anymore; added words go to the log. When a
+ * word file is changed, a new generation with a new shard for it is loaded
+ * next to the current one and swapped in with a single atomic store, and the
+ * old one is freed once no thread can read it anymore. Readers never take a lock.
+ * Writers are serialized by a mutex among themselves, which also covers the
+ * hash index of the log and the journal. Writers that add words at the same
+ * time share one sync of the journal: whoever gets to sync first makes the
+ * records of all the others durable too.
+ */
+typedef struct {
+    _Atomic(DictionaryGeneration *) current;    // Words of the word files, swapped by reloads
+    Catalog *files;             // Names and signatures of the word files, only for reloads
+    WordLog log;                // Words added since startup
+    pthread_mutex_t writer;     // Serializes writers
+    Journal *journal;           // Journal the added words are committed to
+    pthread_mutex_t syncing;    // Held while syncing or compacting the journal, taken before writer
+    size_t written;             // Records written to the journal, under writer
+    atomic_size_t synced;       // Records known to be durable
+} SharedDictionary;
+
+/**
+ * @brief Returns the word of the log at the given index.
+ *
+ * @param log The log.
+ * @param index Index of the word, lower than a count loaded from the log.
+ * @return The null-terminated word.
+ */
+const char *WordLogWord(const WordLog *log, size_t index) {
+    int chunk = HighestBit(index / WORD_LOG_FIRST_CHUNK + 1);
+    return log->chunks[chunk][index - (((size_t)1 << chunk) - 1) * WORD_LOG_FIRST_CHUNK];
+}
+
+/**
+ * @brief Checks whether the log already holds a word. Only for writers.
+ *
+ * @param log The log.
+ * @param from Index of the first word to consider.
+ * @param word The null-terminated word to look for.
+ * @return true if the log contains the word at `from` or later, false otherwise.
+ */
+bool WordLogContains(const WordLog *log, size_t from, const char *word) {
+    if (log->index.capacity == 0) {
+        return false;
+    }
+    size_t mask = log->index.capacity - 1;
+    size_t slot = HashWord(word, strlen(word)) & mask;
+    while (log->index.slots[slot] != 0) {
+        size_t index = log->index.slots[slot] - 1;
+        if (index >= from && strcmp(WordLogWord(log, index), word) == 0) {
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return false;
+}
+
+/**
+ * @brief Puts the word at the given index into the hash index of the log.
+ *
+ * @param log The log, whose index has room for one more word.
+ * @param index Index of the word.
+ */
+void WordLogIndexInsert(WordLog *log, size_t index) {
+    const char *word = WordLogWord(log, index);
+    size_t mask = log->index.capacity - 1;
+    size_t slot = HashWord(word, strlen(word)) & mask;
+    while (log->index.slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    log->index.slots[slot] = index + 1;
+}
+
+/**
+ * @brief Appends a word to the log and publishes it to readers. Only for writers.
+ *
+ * @param log The log.
+ * @param word The null-terminated word, shorter than `MAX_LENGTH`.
+ */
+void WordLogAppend(WordLog *log, const char *word) {
+    size_t count = atomic_load_explicit(&log->count, memory_order_relaxed);
+    size_t length = strlen(word) + 1;
+
+    // Copy the word into the current block, starting a new block when it is full
+    if (log->block == NULL || log->blockUsed + length > WORD_LOG_BLOCK) {
+        char *block = ReallocOrExit(NULL, WORD_LOG_BLOCK);
+        *(char **)block = log->block;   // Blocks are chained for WordLogFree
+        log->block = block;
+        log->blockUsed = sizeof(char *);
+    }
+    char *copy = log->block + log->blockUsed;
+    memcpy(copy, word, length);
+    log->blockUsed += length;
+
+    int chunk = HighestBit(count / WORD_LOG_FIRST_CHUNK + 1);
+    size_t first = (((size_t)1 << chunk) - 1) * WORD_LOG_FIRST_CHUNK;
+    if (log->chunks[chunk] == NULL) {
+        log->chunks[chunk] = ReallocOrExit(NULL, (WORD_LOG_FIRST_CHUNK << chunk) * sizeof(char *));
+    }
+    log->chunks[chunk][count - first] = copy;
+    atomic_store_explicit(&log->count, count + 1, memory_order_release);
+
+    if ((count + 1) * 2 > log->index.capacity) {
+        size_t capacity = log->index.capacity ? log->index.capacity * 2 : 16;
+        free(log->index.slots);
+        log->index.slots = ReallocOrExit(NULL, capacity * sizeof(uint64_t));
+        memset(log->index.slots, 0, capacity * sizeof(uint64_t));
+        log->index.capacity = capacity;
+        for (size_t i = 0; i <= count; i++) {
+            WordLogIndexInsert(log, i);
+        }
+    } else {
+        WordLogIndexInsert(log, count);
+    }
+}
+
+/**
+ * @brief Frees the log once no thread reads it anymore.
+ *
+ * @param log The log.
+ */
+void WordLogFree(WordLog *log) {
+    for (int i = 0; i < WORD_LOG_CHUNKS; i++) {
+        free(log->chunks[i]);
+    }
+    while (log->block != NULL) {
+        char *next = *(char **)log->block;
+        free(log->block);
+        log->block = next;
+    }
+    free(log->index.slots);
+}
+
+/**
+ * @brief Frees a generation of the dictionary that no thread reads anymore.
+ *
+ * @param generation The generation.
+ */
+void DictionaryGenerationFree(DictionaryGeneration *generation) {
+    for (size_t i = 0; i < generation->catalog.count; i++) {
+        if (generation->owned[i]) {
+            DictionaryFree(generation->catalog.shards[i]);
+            free(generation->catalog.shards[i]);
+        }
+    }
+    free(generation);
+}
+
+/**
+ * @brief Starts sharing a loaded catalog between threads.
+ *
+ * @param shared The shared dictionary to initialize.
+ * @param catalog The loaded catalog, whose shards must not be changed while they are shared.
+ * @param journal The journal added words are committed to.
+ */
+void SharedDictionaryInit(SharedDictionary *shared, Catalog *catalog, Journal *journal) {
+    DictionaryGeneration *first = ReallocOrExit(NULL, sizeof(DictionaryGeneration));
+    first->catalog = *catalog;
+    first->logStart = 0;
+    memset(first->owned, 0, sizeof(first->owned));
+    shared->files = catalog;
+    memset(&shared->log, 0, sizeof(shared->log));
+    atomic_init(&shared->log.count, 0);
+    atomic_init(&shared->current, first);
+    pthread_mutex_init(&shared->writer, NULL);
+    shared->journal = journal;
+    pthread_mutex_init(&shared->syncing, NULL);
+    shared->written = 0;
+    atomic_init(&shared->synced, 0);
+}
+
+/**
+ * @brief Stops sharing the dictionary and frees the added words.
+ *
+ * @param shared The shared dictionary.
+ */
+void SharedDictionaryFree(SharedDictionary *shared) {
+    DictionaryGenerationFree(atomic_load(&shared->current));
+    WordLogFree(&shared->log);
+    pthread_mutex_destroy(&shared->writer);
+    pthread_mutex_destroy(&shared->syncing);
+}
+
+/**
+ * @brief Selects a random word without taking a lock.
+ *
+ * Every shard and the log are weighed by their number of words. Words added
+ * while selecting are either fully visible or not at all. Only worker
+ * threads may call this, between `ServerWorkerEnter` and `ServerWorkerLeave`,
+ * so a reload does not free the words meanwhile.
+ *
+ * @param shared The shared dictionary.
+ * @param rng The generator of the calling thread.
+ * @param selectedword Buffer to store the selected word.
+ * @return true if a word was selected, false if there are no words.
+ */
+bool SharedDictionarySelect(SharedDictionary *shared, Rng *rng, char selectedword[MAX_LENGTH]) {
+    const DictionaryGeneration *generation = atomic_load(&shared->current);
+    size_t added = atomic_load_explicit(&shared->log.count, memory_order_acquire) - generation->logStart;
+    size_t loaded = CatalogCount(&generation->catalog), count = loaded + added;
+    if (count == 0) {
+        return false;
+    }
+    uint64_t start = StatStart();
+    size_t index = RngBounded(rng, count), length;
+    if (index < loaded) {
+        const char *word = CatalogWord(&generation->catalog, index, &length);
+        memcpy(selectedword, word, length + 1);
+    } else {
+        strcpy(selectedword, WordLogWord(&shared->log, generation->logStart + index - loaded));
+    }
+    StatStop(STAT_SELECT, start);
+    return true;
+}
+
+/**
+ * @brief Waits until the given number of journal records is durable.
+ *
+ * The first writer to get here syncs the journal once for every record
+ * written so far; the writers that were waiting meanwhile find their records
+ * already durable and return without syncing again.
+ *
+ * @param shared The shared dictionary.
+ * @param records Number of records that must be durable.
+ */
+void SharedDictionarySync(SharedDictionary *shared, size_t records) {
+    if (atomic_load(&shared->synced) >= records) {
+        return;
+    }
+    pthread_mutex_lock(&shared->syncing);
+    if (atomic_load(&shared->synced) < records) {
+        pthread_mutex_lock(&shared->writer);
+        size_t written = shared->written;
+        pthread_mutex_unlock(&shared->writer);
+        FileSync(shared->journal->file);
+        atomic_store(&shared->synced, written);
+    }
+    pthread_mutex_unlock(&shared->syncing);
+}
+
+/**
+ * @brief Adds a word to the shared dictionary and commits it to the journal.
+ *
+ * Only writers wait for each other; readers keep selecting words meanwhile.
+ * The word is durable when the function returns.
+ *
+ * @param shared The shared dictionary.
+ * @param word The null-terminated, valid word to add.
+ * @return true if the word was added, false if it is already in the dictionary.
+ */
+bool SharedDictionaryAdd(SharedDictionary *shared, const char *word) {
+    size_t records = 0;
+    pthread_mutex_lock(&shared->writer);
+    const DictionaryGeneration *generation = atomic_load_explicit(&shared->current, memory_order_relaxed);
+    bool found = CatalogContains(&generation->catalog, word, strlen(word))
+        || WordLogContains(&shared->log, generation->logStart, word);
+    if (!found) {
+        JournalAppend(shared->journal, word, strlen(word));
+        JournalWrite(shared->journal);
+        records = ++shared->written;
+        WordLogAppend(&shared->log, word);
+    }
+    pthread_mutex_unlock(&shared->writer);
+    if (!found) {
+        SharedDictionarySync(shared, records);
+    }
+    return !found;
+}
+
+/**
+ * @brief Merges the journal into the word file while the server keeps running.
+ *
+ * Readers are not affected at all; writers wait until the compaction is done.
+ *
+ * @param shared The shared dictionary.
+ */
+void SharedDictionaryCompact(SharedDictionary *shared) {
+    pthread_mutex_lock(&shared->syncing);
+    pthread_mutex_lock(&shared->writer);
+    JournalCompact(shared->journal);
+    atomic_store(&shared->synced, shared->written);
+    pthread_mutex_unlock(&shared->writer);
+    pthread_mutex_unlock(&shared->syncing);
+}
+
+/**
+ * @brief Loads the word files again that someone else changed, while the server keeps running.
+ *
+ * Before the first word file is reloaded the journal is compacted, so every
+ * word of the log up to then is in the reloaded file; words added while the
+ * file is loaded stay in the log only. The new shards are built without
+ * holding a lock and swapped in at once with a new generation, so readers see
+ * either all of the old or all of the new words, and games in progress keep
+ * their own copy of the word. Only one thread may reload.
+ *
+ * @param shared The shared dictionary.
+ * @return The generation that was replaced, to be freed with
+ *         `ServerRetireGeneration`, or NULL if no word file was changed.
+ */
+DictionaryGeneration *SharedDictionaryReload(SharedDictionary *shared) {
+    Catalog *files = shared->files;
+    FileSignature signatures[CATALOG_MAX_SHARDS];
+    bool changed[CATALOG_MAX_SHARDS], any = false;
+    for (size_t i = 0; i < files->count; i++) {
+        changed[i] = CatalogShardChanged(files, shared->journal, i, &signatures[i]);
+        any = any || changed[i];
+    }
+    if (!any) {
+        return NULL;
+    }
+
+    DictionaryGeneration *current = atomic_load_explicit(&shared->current, memory_order_relaxed);
+    DictionaryGeneration *fresh = ReallocOrExit(NULL, sizeof(DictionaryGeneration));
+    *fresh = *current;
+    if (changed[0]) {
+        pthread_mutex_lock(&shared->syncing);
+        pthread_mutex_lock(&shared->writer);
+        JournalCompact(shared->journal);
+        atomic_store(&shared->synced, shared->written);
+        fresh->logStart = atomic_load_explicit(&shared->log.count, memory_order_relaxed);
+        pthread_mutex_unlock(&shared->writer);
+        pthread_mutex_unlock(&shared->syncing);
+        CatalogShardChanged(files, shared->journal, 0, &signatures[0]);
+    }
+    for (size_t i = 0; i < files->count; i++) {
+        if (changed[i]) {
+            fresh->catalog.shards[i] = ReallocOrExit(NULL, sizeof(Dictionary));
+            fresh->owned[i] = true;
+            DictionaryInit(fresh->catalog.shards[i]);
+            CatalogShardOpen(files, i, fresh->catalog.shards[i]);
+        }
+    }
+
+    pthread_mutex_lock(&shared->writer);
+    DictionaryGeneration *old = atomic_exchange(&shared->current, fresh);
+    pthread_mutex_unlock(&shared->writer);
+    for (size_t i = 0; i < files->count; i++) {
+        if (changed[i]) {
+            CatalogShardLoaded(files, shared->journal, i, &signatures[i]);
+        } else {
+            old->owned[i] = false;  // Handed over to the new generation
+        }
+    }
+    return old;
+}
+
+/**
+ * @brief Statistics of the players shared by all threads of the server.
+ *
+ * Workers record the results of finished games under the lock, which only
+ * ever covers memory. The main thread takes the queued results under the lock
+ * and writes them to the log after releasing it, so a worker never waits for
+ * the disk, not even while a snapshot is written.
+ */
+typedef struct {
+    PlayerStore *store;         // Statistics and queued results under lock, files owned by the main thread
+    pthread_mutex_t lock;       // Covers the statistics, the index and the queue of the store
+    PlayerResult *flushing;     // Results taken from the queue, main thread only
+    size_t flushingCapacity;    // Results allocated for flushing
+} SharedPlayers;
+
+/**
+ * @brief Starts sharing the statistics of the players between threads.
+ *
+ * @param shared The shared statistics to initialize.
+ * @param store The opened store.
+ */
+void SharedPlayersInit(SharedPlayers *shared, PlayerStore *store) {
+    shared->store = store;
+    pthread_mutex_init(&shared->lock, NULL);
+    shared->flushing = NULL;
+    shared->flushingCapacity = 0;
+}
+
+/**
+ * @brief Records the result of a finished game, without any I/O.
+ *
+ * @param shared The shared statistics.
+ * @param name The valid name of the player.
+ * @param won Whether the player won.
+ * @param wrongGuesses Wrong guesses in the game.
+ */
+void SharedPlayersRecord(SharedPlayers *shared, const char *name, bool won, uint64_t wrongGuesses) {
+    pthread_mutex_lock(&shared->lock);
+    PlayerStoreRecord(shared->store, name, won, wrongGuesses);
+    pthread_mutex_unlock(&shared->lock);
+}
+
+/**
+ * @brief Copies the best players under the lock.
+ *
+ * @param shared The shared statistics.
+ * @param top Buffer of `count` statistics to fill.
+ * @param count Number of players to return at most.
+ * @return Number of players returned.
+ */
+size_t SharedPlayersTop(SharedPlayers *shared, PlayerStats *top, size_t count) {
+    pthread_mutex_lock(&shared->lock);
+    size_t found = PlayerStoreTop(shared->store, top, count);
+    pthread_mutex_unlock(&shared->lock);
+    return found;
+}
+
+/**
+ * @brief Writes the queued results to the log, and a snapshot once the log is long.
+ *
+ * Only the main thread flushes. A snapshot is a copy of the statistics taken
+ * under the lock together with the queue, whose results the copy already
+ * holds, so they are dropped instead of being written to the new log.
+ *
+ * @param shared The shared statistics.
+ */
+void SharedPlayersFlush(SharedPlayers *shared) {
+    PlayerStore *store = shared->store;
+    pthread_mutex_lock(&shared->lock);
+    size_t count = PlayerStoreTake(store, &shared->flushing, &shared->flushingCapacity);
+    pthread_mutex_unlock(&shared->lock);
+    PlayerStoreWriteLog(store, shared->flushing, count);
+    if (store->logged < PLAYER_SNAPSHOT_RESULTS) {
+        return;
+    }
+    pthread_mutex_lock(&shared->lock);
+    size_t players = store->count;
+    PlayerStats *copy = ReallocOrExit(NULL, (players + 1) * sizeof(PlayerStats));
+    memcpy(copy, store->players, players * sizeof(PlayerStats));
+    store->pendingCount = 0;
+    pthread_mutex_unlock(&shared->lock);
+    PlayerStoreWriteSnapshot(store, copy, players);
+    free(copy);
+}
+
+/**
+ * @brief Stops sharing the statistics, writing every queued result.
+ *
+ * @param shared The shared statistics.
+ */
+void SharedPlayersFree(SharedPlayers *shared) {
+    SharedPlayersFlush(shared);
+    free(shared->flushing);
+    pthread_mutex_destroy(&shared->lock);
+}
+
+/**
+ * @brief What a connected player is currently doing.
+ */
+typedef enum {
+    SESSION_MENU,       // Choosing between play and add
+    SESSION_PLAYING,    // Guessing letters of a word
+    SESSION_ADDING      // Adding words until "0"
+} SessionMode;
+
+/**
+ * @brief One connected player.
+ *
+ * Input is collected until a whole line has arrived, output is queued and
+ * written whenever the socket accepts more data, so a slow client never
+ * blocks the thread that serves it. Sessions and games come from the pools
+ * of the worker thread; a player between games holds no game record.
+ */
+typedef struct {
+    int fd;                         // Socket of the player
+    SessionMode mode;               // What the player is doing
+    bool closing;                   // Close once the output is written
+    Game *game;                     // Game in progress, only in SESSION_PLAYING
+    char player[PLAYER_NAME_MAX + 1];   // Name the results are recorded under, empty until "name"
+    size_t inputSize;               // Bytes in input
+    size_t outputSize;              // Bytes in output
+    char input[SESSION_INPUT];      // Received bytes not yet handled
+    char output[SESSION_OUTPUT];    // Bytes not yet sent
+} Session;
+
+/**
+ * @brief State shared by all threads of the server.
+ */
+typedef struct {
+    int listener;                   // Listening socket
+    SharedDictionary words;         // Dictionary shared by all sessions
+    SharedPlayers players;          // Statistics of the players of all sessions
+} Server;
+
+/**
+ * @brief Readiness of a socket reported by the event loop.
+ */
+typedef struct {
+    void *data;         // Session of the socket, NULL for the listener
+    bool readable;      // Data or a connection can be read
+    bool writable;      // Output can be written
+    bool hangup;        // The connection is broken
+} ServerEvent;
+
+/**
+ * @brief Set of sockets a worker thread waits on.
+ *
+ * Uses epoll on Linux and poll everywhere else.
+ */
+typedef struct {
+#ifdef __linux__
+    int epoll;
+#else
+    struct pollfd *fds;
+    void **data;
+    size_t count, capacity;
+#endif
+} EventLoop;
+
+/**
+ * @brief One thread of the server with its own event loop.
+ */
+typedef struct {
+    pthread_t thread;
+    Server *server;
+    EventLoop loop;
+    Rng rng;            // Generator of this thread, so selecting never shares state
+    Pool sessions;      // Session records of this thread
+    Pool games;         // Game records of this thread
+    atomic_uint_fast64_t passes;    // Odd while handling events, see ServerWorkerEnter
+} ServerWorker;
+
+/**
+ * @brief Marks the worker as possibly reading the shared dictionary.
+ *
+ * In between handling events a worker holds no pointer into the dictionary,
+ * so counting how often it passed this point is all a reload needs to know
+ * when an old generation can be freed; the workers never wait for a reload.
+ *
+ * @param worker The calling worker.
+ */
+void ServerWorkerEnter(ServerWorker *worker) {
+    atomic_fetch_add(&worker->passes, 1);
+}
+
+/**
+ * @brief Marks the worker as not reading the shared dictionary anymore.
+ *
+ * @param worker The calling worker.
+ */
+void ServerWorkerLeave(ServerWorker *worker) {
+    atomic_fetch_add(&worker->passes, 1);
+}
+
+/**
+ * @brief Frees a replaced generation of the dictionary once no worker can read it anymore.
+ *
+ * A worker that was waiting for events when the generation was replaced, or
+ * that has left the events it was handling since, loads the new generation
+ * the next time it selects a word.
+ *
+ * @param workers The worker threads.
+ * @param threads Number of worker threads.
+ * @param old The replaced generation, which no thread loads anymore.
+ */
+void ServerRetireGeneration(ServerWorker *workers, int threads, DictionaryGeneration *old) {
+    for (int i = 0; i < threads; i++) {
+        uint_fast64_t passes = atomic_load(&workers[i].passes);
+        while (passes % 2 == 1 && atomic_load(&workers[i].passes) == passes) {
+            usleep(1000);
+        }
+    }
+    DictionaryGenerationFree(old);
+}
+
+atomic_int ServerStopping = 0;
+
+/**
+ * @brief Signal handler asking all worker threads to stop.
+ *
+ * @param signal The received signal.
+ */
+void ServerStop(int signal) {
+    (void)signal;
+    ServerStopping = 1;
+}
+
+/**
+ * @brief Switches a socket to non-blocking mode.
+ *
+ * @param fd The socket.
+ */
+void SetNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+/**
+ * @brief Creates an empty event loop, exiting the program if it fails.
+ *
+ * @param loop The event loop to create.
+ */
+void EventLoopInit(EventLoop *loop) {
+#ifdef __linux__
+    loop->epoll = epoll_create1(0);
+    if (loop->epoll < 0) {
+        perror("Error creating event loop");
+        exit(1);
+    }
+#else
+    loop->fds = NULL;
+    loop->data = NULL;
+    loop->count = loop->capacity = 0;
+#endif
+}
+
+/**
+ * @brief Destroys the event loop. The sockets in it are not closed.
+ *
+ * @param loop The event loop to destroy.
+ */
+void EventLoopFree(EventLoop *loop) {
+#ifdef __linux__
+    close(loop->epoll);
+#else
+    free(loop->fds);
+    free(loop->data);
+#endif
+}
+
+/**
+ * @brief Adds a socket to the event loop or changes what it waits for.
+ *
+ * A socket waits either for input or, while output is queued for it, only
+ * for room to write that output, so a client that does not read its answers
+ * is not served further input.
+ *
+ * @param loop The event loop.
+ * @param fd The socket.
+ * @param data Reported back with every event of the socket.
+ * @param writable true to wait until output can be written instead of for input.
+ * @param added true if the socket is already in the loop.
+ */
+void EventLoopWatch(EventLoop *loop, int fd, void *data, bool writable, bool added) {
+#ifdef __linux__
+    struct epoll_event event;
+    event.events = writable ? EPOLLOUT : EPOLLIN;
+#ifdef EPOLLEXCLUSIVE
+    if (data == NULL) {
+        event.events |= EPOLLEXCLUSIVE;     // Wake only one thread per new connection
+    }
+#endif
+    event.data.ptr = data;
+    if (epoll_ctl(loop->epoll, added ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &event) != 0) {
+        perror("Error watching socket");
+        exit(1);
+    }
+#else
+    size_t i = 0;
+    if (added) {
+        while (loop->fds[i].fd != fd) {
+            i++;
+        }
+    } else {
+        if (loop->count == loop->capacity) {
+            loop->capacity = loop->capacity ? loop->capacity * 2 : 16;
+            loop->fds = ReallocOrExit(loop->fds, loop->capacity * sizeof(struct pollfd));
+            loop->data = ReallocOrExit(loop->data, loop->capacity * sizeof(void *));
+        }
+        i = loop->count++;
+    }
+    loop->fds[i].fd = fd;
+    loop->fds[i].events = writable ? POLLOUT : POLLIN;
+    loop->data[i] = data;
+#endif
+}
+
+/**
+ * @brief Removes a socket from the event loop.
+ *
+ * @param loop The event loop.
+ * @param fd The socket.
+ */
+void EventLoopRemove(EventLoop *loop, int fd) {
+#ifdef __linux__
+    epoll_ctl(loop->epoll, EPOLL_CTL_DEL, fd, NULL);
+#else
+    for (size_t i = 0; i < loop->count; i++) {
+        if (loop->fds[i].fd == fd) {
+            loop->count--;
+            loop->fds[i] = loop->fds[loop->count];
+            loop->data[i] = loop->data[loop->count];
+            break;
+        }
+    }
+#endif
+}
+
+/**
+ * @brief Waits until some sockets are ready or the timeout expires.
+ *
+ * @param loop The event loop.
+ * @param events Filled with the ready sockets.
+ * @param max Number of entries in events.
+ * @param timeout Milliseconds to wait at most.
+ * @return The number of ready sockets.
+ */
+int EventLoopWait(EventLoop *loop, ServerEvent *events, int max, int timeout) {
+    int count = 0;
+#ifdef __linux__
+    struct epoll_event ready[SERVER_EVENTS];
+    int n = epoll_wait(loop->epoll, ready, max < SERVER_EVENTS ? max : SERVER_EVENTS, timeout);
+    for (int i = 0; i < n; i++) {
+        events[count].data = ready[i].data.ptr;
+        events[count].readable = (ready[i].events & EPOLLIN) != 0;
+        events[count].writable = (ready[i].events & EPOLLOUT) != 0;
+        events[count].hangup = (ready[i].events & (EPOLLERR | EPOLLHUP)) != 0;
+        count++;
+    }
+#else
+    if (poll(loop->fds, loop->count, timeout) > 0) {
+        for (size_t i = 0; i < loop->count && count < max; i++) {
+            short revents = loop->fds[i].revents;
+            if (revents == 0) {
+                continue;
+            }
+            events[count].data = loop->data[i];
+            events[count].readable = (revents & POLLIN) != 0;
+            events[count].writable = (revents & POLLOUT) != 0;
+            events[count].hangup = (revents & (POLLERR | POLLHUP | POLLNVAL)) != 0;
+            count++;
+        }
+    }
+#endif
+    return count;
+}
+
+/**
+ * @brief Queues formatted output for the player.
+ *
+ * Output that does not fit into the queue is dropped; the input handling
+ * stops reading new lines well before the queue is full.
+ *
+ * @param session The player.
+ * @param format `printf` format of the output.
+ */
+void SessionPrintf(Session *session, const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(session->output + session->outputSize, SESSION_OUTPUT - session->outputSize, format, args);
+    va_end(args);
+    if (written > 0) {
+        session->outputSize += (size_t)written < SESSION_OUTPUT - session->outputSize
+            ? (size_t)written : SESSION_OUTPUT - session->outputSize - 1;
+    }
+}
+
+/**
+ * @brief Queues the board of the game in progress and asks for the next guess.
+ *
+ * @param session The player.
+ */
+void SessionPromptGuess(Session *session) {
+    uint64_t start = StatStart();
+    SessionPrintf(session, "Make your guess %s (%d/%d wrong)\n", GameBoard(session->game), session->game->state, MAX_WRONG_GUESSES);
+    StatStop(STAT_RENDER, start);
+}
+
+/**
+ * @brief Adds a word sent by a player to the shared dictionary and the word file.
+ *
+ * @param server The server.
+ * @param session The player, who is told the outcome.
+ * @param word The word to add.
+ */
+void ServerAddWord(Server *server, Session *session, const char *word) {
+    if (!WordIsValid(word, strlen(word))) {
+        SessionPrintf(session, "Invalid word %s\n", word);
+        return;
+    }
+    if (!SharedDictionaryAdd(&server->words, word)) {
+        SessionPrintf(session, "The word '%s' is already in the file.\n", word);
+    } else {
+        SessionPrintf(session, "Word %s has been added.\n", word);
+    }
+}
+
+/**
+ * @brief Handles one line sent by a player.
+ *
+ * The commands are the same as on the console: "play" starts a game, in which
+ * every line is a guessed letter or word, "add" adds words until "0" is sent, and any
+ * other command ends the session. "add <word>" adds a single word at once.
+ * "name <player>" names the player, whose finished games are then recorded,
+ * and "top" lists the players with the most wins.
+ *
+ * @param worker The thread serving the player.
+ * @param session The player.
+ * @param line The received line without the newline.
+ */
+void SessionHandleLine(ServerWorker *worker, Session *session, char *line) {
+    Server *server = worker->server;
+
+    if (session->mode == SESSION_PLAYING) {
+        ParsedGuess guess;
+        ParseGuess(line, &guess);
+        GuessResult result = GameApplyGuess(session->game, &guess);
+        if (result == GUESS_INVALID) {
+            SessionPrintf(session, "Invalid input. Please enter one letter or the whole word.\n");
+        } else if (result == GUESS_REPEATED) {
+            SessionPrintf(session, "You already guessed %c. Try another letter.\n", guess.letter);
+        }
+        if (GameIsWon(session->game)) {
+            SessionPrintf(session, "You WON! The word was %s\n", GameWord(session->game));
+        } else if (GameIsLost(session->game)) {
+            SessionPrintf(session, "Game Over! The word was %s.\n", GameWord(session->game));
+        } else {
+            SessionPromptGuess(session);
+            return;
+        }
+        if (session->player[0] != '\0') {
+            SharedPlayersRecord(&server->players, session->player, GameIsWon(session->game), (uint64_t)session->game->state);
+        }
+        GameEnd(session->game);
+        PoolRelease(&worker->games, session->game);
+        session->game = NULL;
+        session->mode = SESSION_MENU;
+        SessionPrintf(session, "Do you want to continue play or add?\n");
+        return;
+    }
+
+    if (session->mode == SESSION_ADDING) {
+        if (strcmp(line, "0") == 0) {
+            session->mode = SESSION_MENU;
+            SessionPrintf(session, "Do you want to continue play or add?\n");
+            return;
+        }
+        ServerAddWord(server, session, line);
+        SessionPrintf(session, "If you want to continue adding write the words. Otherwise 0:\n");
+        return;
+    }
+
+    if (strcmp(line, "play") == 0) {
+        char word[MAX_LENGTH];
+        if (!SharedDictionarySelect(&server->words, &worker->rng, word)) {
+            SessionPrintf(session, "No words to guess.\n");
+            return;
+        }
+        session->game = PoolAlloc(&worker->games);
+        GameStart(session->game, word);
+        session->mode = SESSION_PLAYING;
+        SessionPromptGuess(session);
+    } else if (strcmp(line, "add") == 0) {
+        session->mode = SESSION_ADDING;
+        SessionPrintf(session, "Please enter the word you want to add:\n");
+    } else if (strncmp(line, "add ", 4) == 0) {
+        ServerAddWord(server, session, line + 4);
+        SessionPrintf(session, "Do you want to continue play or add?\n");
+    } else if (strncmp(line, "name ", 5) == 0) {
+        if (PlayerNameValid(line + 5)) {
+            strcpy(session->player, line + 5);
+            SessionPrintf(session, "Your games are recorded as %s.\n", session->player);
+        } else {
+            SessionPrintf(session, "Invalid player name %s\n", line + 5);
+        }
+        SessionPrintf(session, "Do you want to continue play or add?\n");
+    } else if (strcmp(line, "top") == 0) {
+        PlayerStats top[PLAYER_TOP];
+        char entry[PLAYER_LINE];
+        size_t count = SharedPlayersTop(&server->players, top, PLAYER_TOP);
+        if (count == 0) {
+            SessionPrintf(session, "No games finished yet.\n");
+        }
+        for (size_t i = 0; i < count; i++) {
+            PlayerStatsLine(entry, i + 1, &top[i]);
+            SessionPrintf(session, "%s", entry);
+        }
+        SessionPrintf(session, "Do you want to continue play or add?\n");
+    } else {
+        SessionPrintf(session, "Looks like you do not want to do any of that. Bye!\n");
+        session->closing = true;
+    }
+}
+
+/**
+ * @brief Writes as much queued output as the socket accepts.
+ *
+ * @param session The player.
+ * @return false if the connection is broken, true otherwise.
+ */
+bool SessionFlush(Session *session) {
+    size_t sent = 0;
+    while (sent < session->outputSize) {
+        ssize_t n = send(session->fd, session->output + sent, session->outputSize - sent, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += (size_t)n;
+    }
+    memmove(session->output, session->output + sent, session->outputSize - sent);
+    session->outputSize -= sent;
+    return true;
+}
+
+/**
+ * @brief Checks whether the input of the player holds a line to handle.
+ *
+ * @param session The player.
+ * @return true if a complete line, or a full buffer, is waiting.
+ */
+bool SessionHasLine(const Session *session) {
+    return session->inputSize == SESSION_INPUT || memchr(session->input, '\n', session->inputSize) != NULL;
+}
+
+/**
+ * @brief Handles all complete lines in the input of the player.
+ *
+ * Lines are only handled while the output queue has room for the answers,
+ * so a player who does not read the answers stops being served instead of
+ * making the server buffer without limit.
+ *
+ * @param worker The thread serving the player.
+ * @param session The player.
+ */
+void SessionHandleInput(ServerWorker *worker, Session *session) {
+    size_t start = 0;
+    while (!session->closing && session->outputSize + SESSION_OUTPUT / 2 <= SESSION_OUTPUT) {
+        char *newline = memchr(session->input + start, '\n', session->inputSize - start);
+        if (newline == NULL) {
+            if (start == 0 && session->inputSize == SESSION_INPUT) {
+                // A line longer than the whole buffer is handled as it is
+                newline = session->input + SESSION_INPUT - 1;
+            } else {
+                break;
+            }
+        }
+        *newline = '\0';
+        if (newline > session->input + start && newline[-1] == '\r') {
+            newline[-1] = '\0';
+        }
+        SessionHandleLine(worker, session, session->input + start);
+        start = (size_t)(newline - session->input) + 1;
+    }
+    memmove(session->input, session->input + start, session->inputSize - start);
+    session->inputSize -= start;
+}
+
+/**
+ * @brief Closes the connection of a player and frees the session.
+ *
+ * @param worker The thread serving the player.
+ * @param session The player.
+ */
+void SessionClose(ServerWorker *worker, Session *session) {
+    EventLoopRemove(&worker->loop, session->fd);
+    close(session->fd);
+    if (session->game != NULL) {
+        GameEnd(session->game);
+        PoolRelease(&worker->games, session->game);
+    }
+    PoolRelease(&worker->sessions, session);
+}
+
+/**
+ * @brief Reads from the socket of a player and answers everything that arrived.
+ *
+ * @param worker The thread serving the player.
+ * @param session The player.
+ * @param event What the socket is ready for.
+ */
+void SessionHandleEvent(ServerWorker *worker, Session *session, const ServerEvent *event) {
+    bool open = !event->hangup || event->readable;
+    while (open && event->readable && session->inputSize < SESSION_INPUT) {
+        ssize_t n = recv(session->fd, session->input + session->inputSize, SESSION_INPUT - session->inputSize, 0);
+        if (n > 0) {
+            session->inputSize += (size_t)n;
+        } else if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            open = false;
+        } else if (errno != EINTR) {
+            break;
+        }
+    }
+    bool flushed;
+    do {
+        SessionHandleInput(worker, session);
+        flushed = SessionFlush(session);
+        // Lines left over because the output was full are handled once it drained
+    } while (flushed && session->outputSize == 0 && !session->closing && SessionHasLine(session));
+    if (!flushed || (session->closing && session->outputSize == 0)
+        || (!open && session->outputSize == 0)) {
+        SessionClose(worker, session);
+        return;
+    }
+    // Wait for room in the socket only while output is queued
+    EventLoopWatch(&worker->loop, session->fd, session, session->outputSize > 0, true);
+}
+
+/**
+ * @brief Accepts all pending connections and starts a session for each.
+ *
+ * @param worker The thread that will serve the new players.
+ */
+void ServerAccept(ServerWorker *worker) {
+    int fd;
+    while ((fd = accept(worker->server->listener, NULL, NULL)) >= 0) {
+        SetNonBlocking(fd);
+        Session *session = PoolAlloc(&worker->sessions);
+        session->fd = fd;
+        session->mode = SESSION_MENU;
+        session->game = NULL;
+        session->player[0] = '\0';
+        session->closing = false;
+        session->inputSize = session->outputSize = 0;
+        SessionPrintf(session, "Do you want to play or add words?\n");
+        SessionFlush(session);
+        EventLoopWatch(&worker->loop, fd, session, session->outputSize > 0, false);
+    }
+}
+
+/**
+ * @brief Main loop of a worker thread.
+ *
+ * @param arg The `ServerWorker` of the thread.
+ * @return Always NULL.
+ */
+void *ServerWorkerRun(void *arg) {
+    ServerWorker *worker = arg;
+    ServerEvent events[SERVER_EVENTS];
+
+    EventLoopWatch(&worker->loop, worker->server->listener, NULL, false, false);
+    while (!ServerStopping) {
+        int count = EventLoopWait(&worker->loop, events, SERVER_EVENTS, 1000);
+        ServerWorkerEnter(worker);
+        for (int i = 0; i < count; i++) {
+            if (events[i].data == NULL) {
+                ServerAccept(worker);
+            } else {
+                SessionHandleEvent(worker, events[i].data, &events[i]);
+            }
+        }
+        ServerWorkerLeave(worker);
+    }
+    return NULL;
+}
+
+/**
+ * @brief Opens the listening socket, exiting the program if it fails.
+ *
+ * @param address A TCP port, or "unix:<path>" for a Unix domain socket.
+ * @return The listening socket.
+ */
+int ServerListen(const char *address) {
+    int fd;
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un local;
+        memset(&local, 0, sizeof(local));
+        local.sun_family = AF_UNIX;
+        snprintf(local.sun_path, sizeof(local.sun_path), "%s", address + 5);
+        unlink(local.sun_path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0 || bind(fd, (struct sockaddr *)&local, sizeof(local)) != 0) {
+            perror("Error opening socket");
+            exit(1);
+        }
+    } else {
+        struct sockaddr_in any;
+        int reuse = 1;
+        memset(&any, 0, sizeof(any));
+        any.sin_family = AF_INET;
+        any.sin_addr.s_addr = htonl(INADDR_ANY);
+        any.sin_port = htons((uint16_t)atoi(address));
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd >= 0) {
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        }
+        if (fd < 0 || bind(fd, (struct sockaddr *)&any, sizeof(any)) != 0) {
+            perror("Error opening socket");
+            exit(1);
+        }
+    }
+    if (listen(fd, SOMAXCONN) != 0) {
+        perror("Error opening socket");
+        exit(1);
+    }
+    SetNonBlocking(fd);
+    return fd;
+}
+
+/**
+ * @brief Closes the listening socket and removes the file of a Unix domain socket.
+ *
+ * @param fd The listening socket.
+ * @param address The address given to `ServerListen`.
+ */
+void ServerUnlisten(int fd, const char *address) {
+    close(fd);
+    if (strncmp(address, "unix:", 5) == 0) {
+        struct sockaddr_un local;
+        snprintf(local.sun_path, sizeof(local.sun_path), "%s", address + 5);
+        unlink(local.sun_path);
+    }
+}
+
+/**
+ * @brief Serves games to many players at once until interrupted.
+ *
+ * Every worker thread runs its own event loop and accepts connections from
+ * the shared listening socket, so thousands of sessions are multiplexed over
+ * a few threads. All sessions share the one dictionary, to which words are
+ * added without ever blocking the threads that select words. The counters of
+ * the hot paths are printed every SERVER_STATS_INTERVAL seconds and on exit.
+ * Meanwhile the main thread compacts the journal of added words into the first
+ * word file every SERVER_COMPACT_INTERVAL seconds and on exit, checks every
+ * second whether anyone else changed a word file, which it then reloads
+ * without interrupting the workers, and writes the results of the games
+ * finished in that second to the log of the players.
+ *
+ * @param catalog The catalog loaded from the word files.
+ * @param journal The journal added words are committed to.
+ * @param players The opened store of the statistics of the players.
+ * @param rng Generator used to seed the generators of the threads.
+ * @param address A TCP port, or "unix:<path>" for a Unix domain socket.
+ * @param threads Number of worker threads.
+ * @return The exit code of the program.
+ */
+int ServeGames(Catalog *catalog, Journal *journal, PlayerStore *players, Rng *rng, const char *address, int threads) {
+    Server server;
+    server.listener = ServerListen(address);
+    SharedDictionaryInit(&server.words, catalog, journal);
+    SharedPlayersInit(&server.players, players);
+
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGINT, ServerStop);
+    signal(SIGTERM, ServerStop);
+
+    ServerWorker *workers = ReallocOrExit(NULL, threads * sizeof(ServerWorker));
+    for (int i = 0; i < threads; i++) {
+        workers[i].server = &server;
+        EventLoopInit(&workers[i].loop);
+        PoolInit(&workers[i].sessions, sizeof(Session), SERVER_POOL_SLAB);
+        PoolInit(&workers[i].games, sizeof(Game), SERVER_POOL_SLAB);
+        RngSeed(&workers[i].rng, RngNext(rng));
+        atomic_init(&workers[i].passes, 0);
+        if (pthread_create(&workers[i].thread, NULL, ServerWorkerRun, &workers[i]) != 0) {
+            perror("Error starting thread");
+            exit(1);
+        }
+    }
+    printf("Serving games on %s with %d threads.\n", address, threads);
+    fflush(stdout);
+
+    // Dump the counters of the hot paths now and then while the workers serve
+    uint64_t lastDump = NowNanoseconds(), lastCompaction = lastDump;
+    while (!ServerStopping) {
+        sleep(1);
+        DictionaryGeneration *old = SharedDictionaryReload(&server.words);
+        if (old != NULL) {
+            ServerRetireGeneration(workers, threads, old);
+            printf("Reloaded the word files, now %zu words in %zu files.\n",
+                   CatalogCount(&atomic_load(&server.words.current)->catalog), catalog->count);
+            fflush(stdout);
+        }
+        if (StatsEnabled && NowNanoseconds() - lastDump >= SERVER_STATS_INTERVAL * 1000000000ULL) {
+            StatsPrint(stdout);
+            lastDump = NowNanoseconds();
+        }
+        if (NowNanoseconds() - lastCompaction >= SERVER_COMPACT_INTERVAL * 1000000000ULL) {
+            SharedDictionaryCompact(&server.words);
+            lastCompaction = NowNanoseconds();
+        }
+        SharedPlayersFlush(&server.players);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+        EventLoopFree(&workers[i].loop);
+        PoolFree(&workers[i].sessions);
+        PoolFree(&workers[i].games);
+    }
+    free(workers);
+    SharedDictionaryCompact(&server.words);
+    if (StatsEnabled) {
+        StatsPrint(stdout);
+    }
+    ServerUnlisten(server.listener, address);
+    SharedDictionaryFree(&server.words);
+    SharedPlayersFree(&server.players);
+    return 0;
+}
+
+#else
+
+int ServeGames(Catalog *catalog, Journal *journal, PlayerStore *players, Rng *rng, const char *address, int threads) {
+    (void)catalog; (void)journal; (void)players; (void)rng; (void)address; (void)threads;
+    printf("Server mode is not supported on this platform.\n");
+    return 1;
+}
+
+#endif